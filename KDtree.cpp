@@ -10,106 +10,363 @@
 #include <string>
 #include <cstdlib>
 #include <vector>
-#include <ctime>
+#include <cmath>
 #include "KDtree.h"
 #include "questions_and_entries.h"
-#include "Stack.h"
 #include "userInput.h"
+#include "splitKernels.h"
+#include "runStats.h"
 
 using namespace std;
 
+// Pools are counted from the columns only when they hold at least this many
+// entries per word of the span they cover, and pools of at least
+// ROW_SLICING_MIN entries that are counted from their rows use bit-sliced
+// counters
+static const size_t COLUMN_DENSITY = 4;
+static const size_t ROW_SLICING_MIN = 16;
+
 // cosntructor KDtree
-// Parameters: Two vectors passed by reference, one of the entries that we will
-//             work with, the other of strings that are the questions
+// Parameters: The shared dataset of the entries that we will work with, the
+//             questions, and the packed matrix of every entry's answers to 
+//             those questions, which must have its columns
 // Does:       Creates and initializes an instance of the KDtree class,
-//             copying data from the given vectors into its own private data
-//             members, then builing a tree of this information, and setting
-//             both root and curr to the root of this tree.
-KDtree::KDtree(vector<Entry> &eVec, vector<Question> &qVec, double vers)
-{
-    srand(time(NULL));
-    entries = eVec;
-    questions = qVec;
+//             keeping a reference to the dataset rather than a copy of it, 
+//             then builing a tree of this information, and setting root to 
+//             the root of this tree. Only the questions that every entry has
+//             an answer for are used to split the pool
+KDtree::KDtree(shared_ptr<const dataset> data, double vers)
+{
+    init(data, vers);
+}
+
+// cosntructor KDtree
+// Parameters: The same as the constructor above, plus the BuildOptions that
+//             say how many threads to build the tree with
+// Does:       Builds the same tree as the constructor above. When more than 
+//             one thread is asked for, a taskPool is started for the length
+//             of the build, and the yes and no subtrees of large pools are 
+//             built as separate tasks
+KDtree::KDtree(shared_ptr<const dataset> data, double vers, 
+               BuildOptions &options)
+{
+    build_options = options;
+    init(data, vers);
+}
+
+// Function init
+// Parameters: The parameters shared by both constructors
+// Returns:    None
+// Does:       Keeps the dataset and then builds the tree, setting root to its
+//             root. A lazy tree starts expanding its root straight away. 
+//             Exits if the dataset's answers have no columns, since they 
+//             cannot be added to a shared dataset
+void KDtree::init(shared_ptr<const dataset> data, double vers)
+{
+    this->data = data;
+    num_questions = data->num_questions();
+    if (data->answers().num_questions() < num_questions) {
+        num_questions = data->answers().num_questions();
+    }
+    if (not data->answers().has_columns()) {
+        cerr << "A KDtree needs the columns of the dataset's answers" << endl;
+        exit(1);
+    }
+
+    tree_version = vers;
+    lazy = build_options.lazy;
+    stopping = false;
+    speculate_target = NO_NODE;
+
+    workers = nullptr;
+    if (build_options.threads > 1 and not lazy) {
+        workers = new taskPool(build_options.threads);
+    }
     root = build_tree(vers);
-    curr = root;
+    node_array = nodes.data();
+    order_array = order.data();
+    mapped = nullptr;
+
+    delete workers;
+    workers = nullptr;
+
+    if (lazy) {
+        speculator = thread(&KDtree::speculate_loop, this);
+    }
+    speculate(root);
+}
+
+// cosntructor KDtree
+// Parameters: A treeFile, passed by reference, that has been mapped and must
+//             outlive this tree
+// Does:       Plays on the tree that was written to the file, pointing at its
+//             mapped Nodes and order rather than building or copying
+//             anything. The questions and entry names are read from the
+//             file's string table only when they are asked for. Exits if the
+//             file's Nodes are not laid out like this program's, or if any of
+//             them is damaged
+KDtree::KDtree(treeFile &file)
+{
+    if (file.node_bytes() != sizeof(Node) or
+        (file.root() != NO_NODE and file.root() >= file.num_nodes())) {
+        cerr << "Tree file does not match this program's tree Nodes" << endl;
+        exit(1);
+    }
+    check_mapped_nodes(file);
+    mapped = &file;
+    node_array = static_cast<const Node *>(file.nodes());
+    order_array = file.order();
+    num_questions = file.num_questions();
+    workers = nullptr;
+    lazy = false;
+    stopping = false;
+    speculate_target = NO_NODE;
+    root = file.root();
+}
+
+// Function check_mapped_nodes
+// Parameters: A treeFile, passed by reference, that has been mapped
+// Returns:    None
+// Does:       Checks every Node of the file once, so that playing on it can
+//             index the Nodes and the order vector without checking them
+//             again: each child is a Node of the file or NO_NODE, each pool
+//             is a range of the order vector, non-empty at a leaf, and each
+//             question is one of the file's, or -1 at a leaf. A tree file is
+//             never lazy, so no Node may be unexpanded. Prints an error and
+//             exits at the first damaged Node
+void KDtree::check_mapped_nodes(treeFile &file)
+{
+    const Node *file_nodes = static_cast<const Node *>(file.nodes());
+    uint32_t num_nodes = file.num_nodes();
+    int64_t num_qs = file.num_questions() < file.num_answers() ?
+                     file.num_questions() : file.num_answers();
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        const Node &node = file_nodes[i];
+        bool leaf = node.question == -1;
+        if ((node.yes != NO_NODE and node.yes >= num_nodes) or
+            (node.no != NO_NODE and node.no >= num_nodes) or
+            node.begin > node.end or node.end > file.num_entries() or
+            (leaf and node.begin == node.end) or
+            node.question < -1 or node.question >= num_qs) {
+            cerr << "Tree file has a damaged Node: " << i << endl;
+            exit(1);
+        }
+    }
+}
+
+// Function write_file
+// Parameters: The name of the file to write, the prompt of the questions file
+//             and the version that the tree was built for
+// Returns:    None
+// Does:       Writes this tree, along with everything that is needed to play
+//             on it, to a treeFile that the constructor above can map
+void KDtree::write_file(string filename, string prompt, double version)
+{
+    treeFile::Contents contents;
+    contents.version = version;
+    contents.root = root;
+    contents.nodes = nodes.data();
+    contents.num_nodes = static_cast<uint32_t>(nodes.size());
+    contents.node_bytes = sizeof(Node);
+    contents.order = order.data();
+    contents.num_entries = static_cast<uint32_t>(order.size());
+    const answerMatrix &answers = data->answers();
+    contents.num_questions = static_cast<uint32_t>(data->num_questions());
+    contents.answer_rows = answers.row(0);
+    contents.num_answers = static_cast<uint32_t>(answers.num_questions());
+    contents.row_words = static_cast<uint32_t>(answers.words_per_row());
+    contents.prompt = prompt;
+    for (size_t i = 0; i < data->num_questions(); i++) {
+        contents.questions.push_back(data->question(i));
+    }
+    for (size_t i = 0; i < data->num_entries(); i++) {
+        contents.names.push_back(data->entry_name(i));
+    }
+    treeFile::write(filename, contents);
+}
+
+// Function scratch
+// Parameters: None
+// Returns:    A reference to the calling thread's Scratch space
+// Does:       Gives every thread that builds part of the tree its own bitset
+//             for marking pools and its own vector of counts, growing the 
+//             bitset if this tree has more entries than it can hold. The
+//             bitset is all zeros whenever it is not in use
+KDtree::Scratch &KDtree::scratch()
+{
+    static thread_local Scratch thread_scratch;
+    size_t column_words = data->answers().words_per_column();
+    if (thread_scratch.pool_bits.size() < column_words) {
+        thread_scratch.pool_bits.resize(column_words, 0);
+    }
+    return thread_scratch;
+}
+
+// Function fork_join
+// Parameters: The size of the pool whose subtrees are being built, the arena
+//             that holds the pool's Node, the index of that Node, and two
+//             functions, one that builds the yes subtree and one that builds
+//             the no subtree, each into the arena that it is given
+// Returns:    None
+// Does:       Runs both functions and links the subtrees that they build to 
+//             the parent Node. When the tree is being built by more than one
+//             thread and the pool is at least as large as the parallel 
+//             cutoff, the yes subtree is handed to the taskPool, where an 
+//             idle thread can steal it, while this thread builds the no 
+//             subtree. Each of the two builds into an arena of its own, and 
+//             the two are then appended to the parent's arena, yes first, 
+//             which puts every Node at the same index that a serial build 
+//             would have. Smaller pools are built one after the other, 
+//             because they are not worth the cost of a task
+void KDtree::fork_join(size_t pool_size, vector<Node> &arena, uint32_t parent,
+                       subtreeTask yes_task, subtreeTask no_task)
+{
+    if (workers == nullptr or pool_size < build_options.parallel_cutoff) {
+        // The arena may grow while a subtree is built, so the parent is only
+        // looked up again once the child's index is known
+        uint32_t yes_child = yes_task(arena);
+        arena[parent].yes = yes_child;
+        uint32_t no_child = no_task(arena);
+        arena[parent].no = no_child;
+    } else {
+        vector<Node> yes_arena, no_arena;
+        uint32_t yes_child = NO_NODE;
+        atomic<int> pending(0);
+        workers->spawn([&]() { yes_child = yes_task(yes_arena); }, pending);
+        uint32_t no_child = no_task(no_arena);
+        workers->wait(pending);
+
+        yes_child = append_subtree(arena, yes_arena, yes_child);
+        arena[parent].yes = yes_child;
+        no_child = append_subtree(arena, no_arena, no_child);
+        arena[parent].no = no_child;
+    }
+}
+
+// Function append_subtree
+// Parameters: The arena to add to, an arena that holds a subtree, and the 
+//             index of that subtree's root in it
+// Returns:    The index of the subtree's root once it has been appended
+// Does:       Moves every Node of the subtree to the end of the arena, 
+//             shifting the indices of their children by the number of Nodes
+//             that were already in the arena
+uint32_t KDtree::append_subtree(vector<Node> &arena, vector<Node> &subtree,
+                                uint32_t subtree_root)
+{
+    if (subtree_root == NO_NODE) {
+        return NO_NODE;
+    }
+
+    uint32_t offset = static_cast<uint32_t>(arena.size());
+    for (size_t i = 0; i < subtree.size(); i++) {
+        Node &node = subtree[i];
+        if (node.yes != NO_NODE) {
+            node.yes += offset;
+        }
+        if (node.no != NO_NODE) {
+            node.no += offset;
+        }
+        arena.push_back(std::move(node));
+    }
+    subtree.clear();
+    return subtree_root + offset;
 }
 
 // Function build_tree
 // Parameters: A double, the version of the program which we want to build a 
 //             tree for
-// Returns:    A pointer to a Node, the root of a tree that we have built
-// Does:       Given the version number as a double, makes a starting pool 
-//             which contains the indices of every entry in the data set, then
-//             calls the appropriate build tree function passing in that vector
-//             of integers as the starting pool
-KDtree::Node *KDtree::build_tree(double version) 
+// Returns:    The index of the Node at the root of the tree that we have built
+// Does:       Given the version number as a double, fills the order vector
+//             with the indices of every entry in the data set, then calls the
+//             appropriate build tree function passing in the whole of that 
+//             vector as the starting pool. A tree of N entries has at 
+//             most 2N - 1 Nodes, so the arena is reserved up front and does 
+//             not have to grow while the tree is built
+uint32_t KDtree::build_tree(double version) 
 {
-    vector<int> starting_pool;
-    for (size_t i = 0; i < entries.size(); i++) {
-        starting_pool.push_back(static_cast<int>(i));
+    order.clear();
+    for (size_t i = 0; i < data->num_entries(); i++) {
+        order.push_back(static_cast<int>(i));
     }
+    uint32_t all = static_cast<uint32_t>(order.size());
+    nodes.clear();
+    nodes.reserve(2 * data->num_entries());
 
-    if (version == 0.0) {
-        return build_tree_order(starting_pool, 0);
+    if (lazy) {
+        return make_lazy_node(0, all, 0);
+    } else if (version == 0.0) {
+        return build_tree_order(0, all, 0, nodes);
     } else if (version == 1.0) {
-        return build_tree_best(starting_pool);
+        return build_tree_best(0, all, nodes);
     } else if (version == 1.1) {
-        return build_tree_sample(starting_pool);
+        return build_tree_sample(0, all, nodes);
     } else if (version == 1.5) {
-        return build_tree_sums(starting_pool);
+        return build_tree_sums(0, all, nodes);
     } else if (version == 2.0) {
-        return build_tree_best(starting_pool);
+        return build_tree_best(0, all, nodes);
     } else if (version == 3.0) {
-        return build_tree_sample(starting_pool);
+        return build_tree_sample(0, all, nodes);
     } else {
-        return nullptr;
+        return NO_NODE;
     }
 }
 
 // Destructor ~KDtree
-// Does: Recycles all memory used to store this class's tree by calling the 
-//       recursive "delete_tree" function at the tree's root
+// Does: Stops the speculating thread of a lazy tree. Every Node lives in the
+//       nodes arena, which is freed all at once
 KDtree::~KDtree() 
 {
-    curr = nullptr;
-    root = delete_tree(root);
-}
-
-// function delete_tree
-// Parameters: A pointer to a Node, node
-// Returns:    A pointer to a Node, node, which will always be the nullptr
-// Does:       Recursive function that performs a post-order delete of this
-//             binary tree
-KDtree::Node *KDtree::delete_tree(Node *node)
-{
-    // Base case #1: the given node is the nullptr, in which case there is 
-    // nothing to delete- just return nullptr back again
-    if (node == nullptr) {
-        return nullptr;
-    } else if (node->yes == nullptr and node->no == nullptr) {
-    // Base case #2: the given node is a leaf node, in which case, we delete 
-    // the node safely without worrying about the node's yes and no pointers
-        delete node;
-        return nullptr;
-    } else {
-    // Recursive case: one or both of the next pointers have subtrees. In this
-    // case, we delete those first, then delete the current node post order
-        node->yes = delete_tree(node->yes);
-        node->no = delete_tree(node->no);
-        delete node;
-        return nullptr;
+    if (speculator.joinable()) {
+        {
+            lock_guard<mutex> guard(expand_lock);
+            stopping = true;
+        }
+        speculate_wake.notify_one();
+        speculator.join();
     }
 }
 
+// Function start_game
+// Parameters: None
+// Returns:    A GameCursor for a new game on this tree
+// Does:       Makes a cursor at the root that has no answers yet. Any number
+//             of games may be played on the tree at once, each with a cursor
+//             of its own, since playing never changes the tree
+KDtree::GameCursor KDtree::start_game()
+{
+    GameCursor game;
+    game.tree = this;
+    game.reset();
+    return game;
+}
+
 // function reset
-// Parameters: Node
+// Parameters: None
 // Returns:    None
-// Does:       Sets the current pointer to the root of the tree, in case I 
-//             want to imlepent a "play again" feature without rebuilding the
-//             tree
-void KDtree::reset()
+// Does:       Sets the current pointer to the root of the tree and forgets 
+//             the answers of the last game, so that the cursor can be used 
+//             to play again without rebuilding the tree
+void KDtree::GameCursor::reset()
 {
-    curr = root;
+    move_to(tree->root);
+    clear_answers();
+}
+
+// function clear_answers
+// Parameters: None
+// Returns:    None
+// Does:       Forgets every answer given in this game, and every probably and
+//             unknown that could be returned to, by sizing the per-game 
+//             bitsets to one bit per question and zeroing them
+void KDtree::GameCursor::clear_answers()
+{
+    size_t words = (tree->num_questions + 63) / 64;
+    answered.assign(words, 0);
+    answered_yes.assign(words, 0);
+    answered_maybe.assign(words, 0);
+
+    probablies.clear();
+    unknowns.clear();
 }
 
 // function advance
@@ -118,15 +375,15 @@ void KDtree::reset()
 // Returns:    None
 // Does:       Moves the current pointer to the appropriate next pointer (yes
 //             if yes is true, no if yes is false.
-void KDtree::advance(bool yes)
+void KDtree::GameCursor::advance(bool yes)
 {
-    if (curr == nullptr) {
+    if (curr == NO_NODE) {
         return;
     } else {
         if (yes) {
-            curr = curr->yes;
+            move_to(tree->at(curr).yes);
         } else {
-            curr = curr->no;
+            move_to(tree->at(curr).no);
         }
     }
 }
@@ -138,15 +395,27 @@ void KDtree::advance(bool yes)
 //             entries at the node that curr points to. The reason for this 
 //             return is that the client can know when there is one entry left
 //             that it could be so they know when to make a guess
-int KDtree::size_of_pool()
+int KDtree::GameCursor::size_of_pool()
 {
-    if (curr == nullptr) {
+    if (curr == NO_NODE) {
         return 0;
     } else {
-        return static_cast<int>(curr->correct_entries.size());
+        Node node = tree->at(curr);
+        return static_cast<int>(node.end - node.begin);
     }
 }
 
+// Function can_ask
+// Parameters: None
+// Returns:    A bool, true if there is a question to ask of the pool at the
+//             current Node, and false if it is time to guess, because the
+//             pool holds at most one entry, or is a leaf of entries that 
+//             answer every question the same way
+bool KDtree::GameCursor::can_ask()
+{
+    return size_of_pool() > 1 and question_index_at_curr() >= 0;
+}
+
 // Function advance_probably
 // Parameters: A value of type userInput, UI
 // Returns:    None 
@@ -164,47 +433,89 @@ int KDtree::size_of_pool()
 //             or probably-not, they are more sure of their answer than a 
 //             player who answers unknown, and therefore there is a greater 
 //             chance that unknown was answered incorrectly
-void KDtree::advance_probably(userInput UI)
+void KDtree::GameCursor::advance_probably(userInput UI)
 {
-    if (curr == nullptr) {
+    if (curr == NO_NODE) {
         return;
     } else {
-        set_question_truth(curr->question, UI);
+        set_question_truth(tree->at(curr).question, UI);
         if (UI == yes) {
-            curr = curr->yes;
+            move_to(tree->at(curr).yes);
         } else if (UI == no) {
-            curr = curr->no;
+            move_to(tree->at(curr).no);
         } else if (UI == prob) {
             add_probably(true);
-            curr = curr->yes;
+            move_to(tree->at(curr).yes);
         } else if (UI == probnot) {
             add_probably(false);
-            curr = curr->no;
+            move_to(tree->at(curr).no);
         } else {
             // We set question truth to probnot instead of unknown, because
             // we don't want to ask this question again per "skip_answered_
             // questions"
-            set_question_truth(curr->question, probnot);
+            set_question_truth(tree->at(curr).question, probnot);
             add_unknown();
-            curr = curr->no;
+            move_to(tree->at(curr).no);
         }
         skip_answered_questions();
     }
 }
 
 // Function set_question_truth
-// Parameters: A string, questionStr, and a userInput UI
+// Parameters: The index of a question, q_index, and a userInput UI
 // Returns:    None
-// Does:       Finds the question in the questions vertex to find the question
-//             with the same name as the one given as the questionStr. Then it
-//             sets that question's truth variable to the given userInput
-void KDtree::set_question_truth(string questionStr, userInput UI)
-{
-    for (size_t i = 0; i < questions.size(); i++) {
-        if (questions[i].question == questionStr) {
-            questions[i].truth = UI;
-            return;
-        }
+// Does:       Records the given userInput as the answer to the question in 
+//             the three per-game bitsets: answered is set for every value
+//             except unknown, answered_yes for yes and prob, and 
+//             answered_maybe for prob and probnot. Does nothing for the 
+//             question index of a leaf, which is -1
+void KDtree::GameCursor::set_question_truth(int q_index, userInput UI)
+{
+    if (q_index < 0) {
+        return;
+    }
+    set_bit(answered, q_index, UI != unknown);
+    set_bit(answered_yes, q_index, UI == yes or UI == prob);
+    set_bit(answered_maybe, q_index, UI == prob or UI == probnot);
+}
+
+// Function question_truth
+// Parameters: The index of a question, q_index
+// Returns:    The userInput that the player gave as the answer to that 
+//             question in this game, or unknown if they have not answered it
+// Does:       Decodes the answer from the three per-game bitsets
+userInput KDtree::GameCursor::question_truth(int q_index)
+{
+    if (q_index < 0 or not test_bit(answered, q_index)) {
+        return unknown;
+    }
+    bool leans_yes = test_bit(answered_yes, q_index);
+    if (test_bit(answered_maybe, q_index)) {
+        return leans_yes ? prob : probnot;
+    }
+    return leans_yes ? yes : no;
+}
+
+// Function test_bit
+// Parameters: A bitset, passed by reference, and the index of a bit in it
+// Returns:    A bool, the value of that bit
+bool KDtree::GameCursor::test_bit(const vector<uint64_t> &bits, size_t index)
+{
+    return (bits[index >> 6] >> (index & 63)) & 1;
+}
+
+// Function set_bit
+// Parameters: A bitset, passed by reference, the index of a bit in it and the
+//             value to give that bit
+// Returns:    None
+void KDtree::GameCursor::set_bit(vector<uint64_t> &bits, size_t index, 
+                                 bool value)
+{
+    uint64_t mask = static_cast<uint64_t>(1) << (index & 63);
+    if (value) {
+        bits[index >> 6] |= mask;
+    } else {
+        bits[index >> 6] &= ~mask;
     }
 }
 
@@ -217,30 +528,29 @@ void KDtree::set_question_truth(string questionStr, userInput UI)
 //             probably/probably-not/unknwon node, we don't end up asking 
 //             questions that had been answered in that previous branch, and as
 //             a consequence, wasting some of our precious 20 opportunities to
-//             narrow down the pool
-void KDtree::skip_answered_questions() 
+//             narrow down the pool. Each Node's question is looked up by its 
+//             index, so checking a Node takes constant time
+void KDtree::GameCursor::skip_answered_questions() 
 {
-    userInput current_truth = unknown;
-    for (size_t i = 0; i < questions.size(); i++) {
-        if (questions[i].question == curr->question) {
-            current_truth = questions[i].truth;
-        }
-    }
     // If the pool is less than or equal to one in size, then there are no 
     // quesions to be answered
     if (size_of_pool() <= 1) {
         return;
-    } else if (current_truth != unknown) {
+    }
+
+    userInput current_truth = question_truth(tree->at(curr).question);
+    if (current_truth != unknown) {
+        runStats::add(runStats::QUESTIONS_SKIPPED);
         if (current_truth == yes) {
-            curr = curr->yes;
+            move_to(tree->at(curr).yes);
         } else if (current_truth == no) {
-            curr = curr->no;
+            move_to(tree->at(curr).no);
         } else if (current_truth == prob) {
             add_probably(true);
-            curr = curr->yes;
+            move_to(tree->at(curr).yes);
         } else if (current_truth == probnot) {
             add_probably(false);
-            curr = curr->no;
+            move_to(tree->at(curr).no);
         }
         // Recursively calls itself if a question was skipped in order to skip 
         // other subsequent unanswered questions if they exist
@@ -260,28 +570,30 @@ void KDtree::skip_answered_questions()
 //             answered questions that might be in this path. We repeat this 
 //             process for the probalies and probably-nots if the unknowns 
 //             was empty.
-bool KDtree::return_to_probably()
+bool KDtree::GameCursor::return_to_probably()
 {
-    if (not unknowns.is_empty()) {
-        Unknown recent_unkwn = unknowns.top();
-        unknowns.pop();
+    if (not unknowns.empty()) {
+        Unknown recent_unkwn = unknowns.back();
+        unknowns.pop_back();
         if (recent_unkwn.yes) {
-            curr = recent_unkwn.unkwn_ptr->no;
+            move_to(tree->at(recent_unkwn.unkwn_node).no);
         } else {
-            curr = recent_unkwn.unkwn_ptr->yes;
+            move_to(tree->at(recent_unkwn.unkwn_node).yes);
         }
         skip_answered_questions();
+        runStats::add(runStats::BACKTRACKS);
         return true;
-    } else if (not probablies.is_empty()) {
-        Probably recent_prob = probablies.top();
-        probablies.pop();
+    } else if (not probablies.empty()) {
+        Probably recent_prob = probablies.back();
+        probablies.pop_back();
 
         if (recent_prob.yes) {
-            curr = recent_prob.prob_ptr->no;
+            move_to(tree->at(recent_prob.prob_node).no);
         } else {
-            curr = recent_prob.prob_ptr->yes;
+            move_to(tree->at(recent_prob.prob_node).yes);
         }
         skip_answered_questions();
+        runStats::add(runStats::BACKTRACKS);
         return true;
     } 
     return false;
@@ -291,64 +603,256 @@ bool KDtree::return_to_probably()
 // Parameters: A boolean, yes
 // Returns:    None
 // Does:       Adds an element to the probablies stack whose yes value is set
-//             to the given boolean and whose node pointer is set to the curr
-//             pointer
-void KDtree::add_probably(bool yes)
+//             to the given boolean and whose node index is set to the curr
+//             index
+void KDtree::GameCursor::add_probably(bool yes)
 {
     Probably new_prob;
     new_prob.yes = yes;
-    new_prob.prob_ptr = curr;
-    probablies.push(new_prob);
+    new_prob.prob_node = curr;
+    probablies.push_back(new_prob);
 }
 
 // Function add_unknown
 // Parameters: None
 // Returns:    None
 // Does:       Adds an element to the unknowns stack whose yes value is set to
-//             false and whose node pointer value is set to the curr pointer
-void KDtree::add_unknown()
+//             false and whose node index is set to the curr index
+void KDtree::GameCursor::add_unknown()
 {
     Unknown new_unkwn;
     new_unkwn.yes = false;
-    new_unkwn.unkwn_ptr = curr;
-    unknowns.push(new_unkwn);
+    new_unkwn.unkwn_node = curr;
+    unknowns.push_back(new_unkwn);
 }
 
 
 // function question_at_curr
 // Parameters: None
 // Returns:    A string
-// Does:       Getter function that returns the question data at the current 
-//             Node. Returns the empty string as a saftey measure in case the 
-//             current Node was advanced all the way to the nullptr
-string KDtree::question_at_curr() 
+// Does:       Getter function that returns the question asked at the current 
+//             Node. Returns the string " " as a saftey measure in case the 
+//             current Node was advanced all the way to NO_NODE, or is a leaf
+//             that asks no question
+string KDtree::GameCursor::question_at_curr() 
 {
-    if (curr == nullptr) {
+    int q_index = question_index_at_curr();
+    if (q_index < 0) {
         return " ";
+    } else if (tree->mapped != nullptr) {
+        return tree->mapped->question(q_index);
     } else {
-        return curr->question;
+        return tree->data->question(q_index);
     }
 }
 
+// function question_index_at_curr
+// Parameters: None
+// Returns:    The index of the question asked at the current Node, or -1 if
+//             the current Node is NO_NODE or a leaf
+int KDtree::GameCursor::question_index_at_curr()
+{
+    return curr == NO_NODE ? -1 : tree->at(curr).question;
+}
+
 // function entry_at_curr
 // Parameters: None
 // Returns:    A string
 // Does:       Getter function that returns the first element in the pool of 
 //             correct entries in a node. Only practical when making a guess
-string KDtree::entry_at_curr() 
+string KDtree::GameCursor::entry_at_curr() 
 {
-    if (curr == nullptr) {
+    if (curr == NO_NODE) {
         return "No entries that match these answers";
+    } else if (tree->mapped != nullptr) {
+        return tree->mapped->entry_name(tree->first_entry_at(curr));
     } else {
-        return entries[curr->correct_entries[0]].name; 
+        return tree->data->entry_name(tree->first_entry_at(curr));
+    }
+}
+
+// Function move_to
+// Parameters: The index of a Node, or NO_NODE
+// Returns:    None
+// Does:       Makes the Node the current one, and lets the tree know that a
+//             game has reached it
+void KDtree::GameCursor::move_to(uint32_t index)
+{
+    curr = index;
+    tree->speculate(index);
+}
+
+// Function put_number
+// Parameters: A string of saved state, passed by reference, and a number
+// Returns:    None
+// Does:       Appends the number to the state seven bits at a time, lowest
+//             first, with the high bit of every byte but the last one set, so
+//             that a number below 128 takes a single byte
+static void put_number(string &state, uint64_t number)
+{
+    while (number >= 0x80) {
+        state += static_cast<char>((number & 0x7F) | 0x80);
+        number >>= 7;
+    }
+    state += static_cast<char>(number);
+}
+
+// Function take_number
+// Parameters: A string of saved state, the position in it to read from and
+//             the number that is read, both passed by reference
+// Returns:    A bool, false if the state ends in the middle of the number or
+//             the number is too long to be one that put_number wrote
+// Does:       Reads a number written by put_number and moves past it
+static bool take_number(const string &state, size_t &at, uint64_t &number)
+{
+    number = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (at >= state.size()) {
+            return false;
+        }
+        uint8_t byte = static_cast<uint8_t>(state[at++]);
+        number |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function save
+// Parameters: A string, passed by reference, that the state is appended to
+// Returns:    None
+// Does:       Writes the state of the game as a handful of numbers: the 
+//             current Node, the probablies and unknowns, each a Node and its
+//             side, and the questions that have been answered, each as the 
+//             gap from the last one along with its answered_yes and 
+//             answered_maybe bits. A game of twenty questions saves to a few
+//             dozen bytes, however many questions and Nodes the tree has
+void KDtree::GameCursor::save(string &state)
+{
+    put_number(state, curr == NO_NODE ? 0 : curr + 1ull);
+
+    put_number(state, probablies.size());
+    for (size_t i = 0; i < probablies.size(); i++) {
+        put_number(state, (static_cast<uint64_t>(probablies[i].prob_node) << 1)
+                          | probablies[i].yes);
+    }
+    put_number(state, unknowns.size());
+    for (size_t i = 0; i < unknowns.size(); i++) {
+        put_number(state, (static_cast<uint64_t>(unknowns[i].unkwn_node) << 1)
+                          | unknowns[i].yes);
+    }
+
+    size_t num_answered = 0;
+    for (size_t q = 0; q < tree->num_questions; q++) {
+        num_answered += test_bit(answered, q);
+    }
+    put_number(state, num_answered);
+    size_t next_q = 0;
+    for (size_t q = 0; q < tree->num_questions; q++) {
+        if (test_bit(answered, q)) {
+            uint64_t bits = test_bit(answered_yes, q) | 
+                            test_bit(answered_maybe, q) << 1;
+            put_number(state, (static_cast<uint64_t>(q - next_q) << 2) | bits);
+            next_q = q + 1;
+        }
+    }
+}
+
+// Function restore
+// Parameters: A string of state written by save, and the position in it to
+//             read from, passed by reference
+// Returns:    A bool, false if the state is cut short or names a Node or a
+//             question that this tree does not have
+// Does:       Puts this cursor in the game that was saved, and moves past the
+//             state. The cursor is left as it was if the state is bad. Node
+//             indices are only the same in trees built the same way, so a 
+//             lazy tree, whose Nodes are numbered in the order that they were
+//             expanded, can only restore the games that were saved from it
+bool KDtree::GameCursor::restore(const string &state, size_t &at)
+{
+    GameCursor restored;
+    restored.tree = tree;
+    restored.clear_answers();
+    uint32_t num_nodes = tree->node_count();
+    uint64_t number, count;
+
+    if (not take_number(state, at, number) or number > num_nodes) {
+        return false;
+    }
+    restored.curr = number == 0 ? NO_NODE : number - 1;
+
+    if (not take_number(state, at, count)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        if (not take_number(state, at, number) or number >> 1 >= num_nodes) {
+            return false;
+        }
+        Probably prob;
+        prob.yes = number & 1;
+        prob.prob_node = number >> 1;
+        restored.probablies.push_back(prob);
+    }
+    if (not take_number(state, at, count)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        if (not take_number(state, at, number) or number >> 1 >= num_nodes) {
+            return false;
+        }
+        Unknown unkwn;
+        unkwn.yes = number & 1;
+        unkwn.unkwn_node = number >> 1;
+        restored.unknowns.push_back(unkwn);
+    }
+
+    if (not take_number(state, at, count)) {
+        return false;
+    }
+    size_t next_q = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        if (not take_number(state, at, number) or 
+            number >> 2 >= tree->num_questions - next_q) {
+            return false;
+        }
+        size_t q = next_q + (number >> 2);
+        set_bit(restored.answered, q, true);
+        set_bit(restored.answered_yes, q, number & 1);
+        set_bit(restored.answered_maybe, q, number & 2);
+        next_q = q + 1;
+    }
+
+    *this = std::move(restored);
+    move_to(curr);
+    return true;
+}
+
+// Function speculate
+// Parameters: The index of a Node that a game has reached, or NO_NODE
+// Returns:    None
+// Does:       In a lazy tree, asks the speculating thread to expand the Node
+//             and its children, so that whichever way the player answers, the
+//             next Node is likely to be ready by the time that they do. When
+//             several games are played on the tree at once, the Node of the
+//             one that moved last is expanded first
+void KDtree::speculate(uint32_t index)
+{
+    if (lazy and index != NO_NODE) {
+        {
+            lock_guard<mutex> guard(expand_lock);
+            speculate_target = index;
+        }
+        speculate_wake.notify_one();
     }
 }
 
 // function build_tree_order
-// Parameters: A vector of integers, the pool of integers that correspend to 
-//             the indicies of entries that could still be the mystery entry,
-//             as well as the number question that we are currently asking
-// Returns:    A pointer to a node, the root of a constructed subtree of the 
+// Parameters: The range [begin, end) of the order vector that holds the pool
+//             of indices of entries that could still be the mystery entry,
+//             as well as the number question that we are currently asking and
+//             the arena to add the subtree's Nodes to
+// Returns:    The index of a node, the root of a constructed subtree of the 
 //             kd-tree that is completed
 // Does:       Recursive function that inserts the current pool of data and 
 //             question string into the proper fields of a Node struct, then
@@ -356,37 +860,37 @@ string KDtree::entry_at_curr()
 //             and uses that data and the next index question of the questions
 //             vector to recursively build the subtrees for its yes and no 
 //             pointers. Stops when there is one entry left in the pool, 
-//             becuase there is not a need to divide that data any further
-KDtree::Node *KDtree::build_tree_order(vector<int> pool, int q_num)
+//             becuase there is not a need to divide that data any further, or
+//             when every question has been asked, leaving a leaf of the 
+//             entries that answered them all the same way
+uint32_t KDtree::build_tree_order(uint32_t begin, uint32_t end, int q_num, 
+                                  vector<Node> &arena)
 {
-    if (pool.size() < 1) {
-        return nullptr;
-    } else if (pool.size() == 1) {
-        Node *new_node = make_node(pool[0]);
-        return new_node;
+    if (end - begin < 1) {
+        return NO_NODE;
+    } else if (end - begin == 1) {
+        return make_node(begin, arena);
+    } else if (static_cast<size_t>(q_num) >= num_questions) {
+        return make_node(begin, end, -1, arena);
     } else {
-        Node *new_node = make_node(pool, q_num);
-
-        vector<int> yes_pool, no_pool;
-        for (size_t i = 0; i < pool.size(); i++) {
-            if (entries[pool[i]].answers[q_num] == 0) {
-                no_pool.push_back(pool[i]);
-            } else {
-                yes_pool.push_back(pool[i]);
-            }
-        }
+        uint32_t new_node = make_node(begin, end, q_num, arena);
+        uint32_t middle = partition_pool(begin, end, q_num);
 
-        new_node->yes = build_tree_order(yes_pool, q_num + 1);
-        new_node->no = build_tree_order(no_pool, q_num + 1);
+        fork_join(end - begin, arena, new_node,
+                  [&](vector<Node> &a) { 
+                      return build_tree_order(begin, middle, q_num + 1, a); },
+                  [&](vector<Node> &a) { 
+                      return build_tree_order(middle, end, q_num + 1, a); });
         return new_node;
     }
 }
 
 // Function build_tree_best 
-// Parameters: A vector of integers, the indices of the entries that, given the
-//             current order of questions asked already, could be the correct 
-//             one which we are trying to guess
-// Returns:    A pointer to a node, the root of the subtree which we have just 
+// Parameters: The range [begin, end) of the order vector that holds the 
+//             indices of the entries that, given the current order of 
+//             questions asked already, could be the correct one which we are
+//             trying to guess, and the arena to add the subtree's Nodes to
+// Returns:    The index of a node, the root of the subtree which we have just 
 //             built
 // Does:       Similar function to build_tree_order, but here, rather than just
 //             calling the next question in the order that they appear in the 
@@ -396,31 +900,31 @@ KDtree::Node *KDtree::build_tree_order(vector<int> pool, int q_num)
 //             how a human plays twenty questions, if we already know a fact
 //             about the entry which we are trying to guess, there is no need
 //             to ask a question which only divides the entries for which that
-//             fact is untrue.
-KDtree::Node *KDtree::build_tree_best(vector<int> pool) 
+//             fact is untrue. If even the best question does not divide the
+//             pool, its entries answer every question the same way, and they
+//             are left together in a leaf
+uint32_t KDtree::build_tree_best(uint32_t begin, uint32_t end, 
+                                 vector<Node> &arena) 
 {
-    if (pool.size() < 1) {
-        return nullptr;
-    } else if (pool.size() == 1) {
-        Node *new_node = make_node(pool[0]);
-        return new_node;
+    if (end - begin < 1) {
+        return NO_NODE;
+    } else if (end - begin == 1) {
+        return make_node(begin, arena);
     } else {
         // Here we find the best (most polarizing question) and use that to
         // divide the pool into a yes-pool and  a no-pool
-        int best_index = select_best_question(pool);
-        Node *new_node = make_node(pool, best_index);
-
-        vector<int> yes_pool, no_pool;
-        for (size_t i = 0; i < pool.size(); i++) {
-            if (entries[pool[i]].answers[best_index] == 0) {
-                no_pool.push_back(pool[i]);
-            } else {
-                yes_pool.push_back(pool[i]);
-            }
+        int best_index = select_best_question(&order[begin], end - begin);
+        uint32_t middle = partition_pool(begin, end, best_index);
+        if (middle == begin or middle == end) {
+            return make_node(begin, end, -1, arena);
         }
+        uint32_t new_node = make_node(begin, end, best_index, arena);
 
-        new_node->yes = build_tree_best(yes_pool);
-        new_node->no = build_tree_best(no_pool);
+        fork_join(end - begin, arena, new_node,
+                  [&](vector<Node> &a) { 
+                      return build_tree_best(begin, middle, a); },
+                  [&](vector<Node> &a) { 
+                      return build_tree_best(middle, end, a); });
         return new_node;
     }
 }
@@ -429,52 +933,57 @@ KDtree::Node *KDtree::build_tree_best(vector<int> pool)
 // decides the most polarizing subset from that
 
 // Function build_tree_sample
-// Parameters: A vector of integers, the indices of the entries that, given the
-//             current order of questions asked already, could be the correct 
-//             one which we are trying to guess
-// Returns:    A pointer to a Node, the root of the subtree which we have just 
+// Parameters: The range [begin, end) of the order vector that holds the 
+//             indices of the entries that, given the current order of 
+//             questions asked already, could be the correct one which we are
+//             trying to guess, and the arena to add the subtree's Nodes to
+// Returns:    The index of a Node, the root of the subtree which we have just 
 //             built
 // Does:       Builds a subtree in the same way as build_tree_best, but here 
 //             we attempt to have better runtime because rather than searching
 //             through the entire remaining pool of entries, we take a random
-//             sample set of size 10, and look through those to find the best 
-//             question. 
-KDtree::Node *KDtree::build_tree_sample(vector<int> pool) 
-{
-    if (pool.size() < 1) {
-        return nullptr;
-    } else if (pool.size() == 1) {
-        Node *new_node = make_node(pool[0]);
-        return new_node;
-    } else if (pool.size() < 10) {
-        // If the size is less than 10, we can't make a sample set of size 10
-        return build_tree_best(pool);
+//             sample set, and look through those to find the best question. 
+//             See select_sample_question for how large the sample is. If the
+//             question does not divide the pool, the sample was all alike,
+//             so the question is chosen from the whole pool instead, and if
+//             even that one does not divide it, the pool is left in a leaf
+uint32_t KDtree::build_tree_sample(uint32_t begin, uint32_t end, 
+                                   vector<Node> &arena) 
+{
+    if (end - begin < 1) {
+        return NO_NODE;
+    } else if (end - begin == 1) {
+        return make_node(begin, arena);
+    } else if (end - begin <= build_options.sample_size) {
+        // If the pool is no larger than a sample, we look at all of it
+        return build_tree_best(begin, end, arena);
     } else {
-        vector<int> sample_set;
-        make_sample_set(sample_set, pool);
-        int best_index = select_best_question(sample_set);
-        Node *new_node = make_node(pool, best_index);
-
-        vector<int> yes_pool, no_pool;
-        for (size_t i = 0; i < pool.size(); i++) {
-            if (entries[pool[i]].answers[best_index] == 0) {
-                no_pool.push_back(pool[i]);
-            } else {
-                yes_pool.push_back(pool[i]);
-            }
+        int best_index = select_sample_question(begin, end);
+        uint32_t middle = partition_pool(begin, end, best_index);
+        if (middle == begin or middle == end) {
+            best_index = select_best_question(&order[begin], end - begin);
+            middle = partition_pool(begin, end, best_index);
         }
+        if (middle == begin or middle == end) {
+            return make_node(begin, end, -1, arena);
+        }
+        uint32_t new_node = make_node(begin, end, best_index, arena);
 
-        new_node->yes = build_tree_sample(yes_pool);
-        new_node->no = build_tree_sample(no_pool);
+        fork_join(end - begin, arena, new_node,
+                  [&](vector<Node> &a) { 
+                      return build_tree_sample(begin, middle, a); },
+                  [&](vector<Node> &a) { 
+                      return build_tree_sample(middle, end, a); });
         return new_node;
     }
 }
 
 // Function build_tree_sums
-// Parameters: A vector of integers, the indices of the entries that, given the
-//             current order of questions asked, could be the entry which we 
-//             are trying to guess
-// Returns:    A Node pointer to the root of the tree we have just built
+// Parameters: The range [begin, end) of the order vector that holds the 
+//             indices of the entries that, given the current order of 
+//             questions asked, could be the entry which we are trying to 
+//             guess, and the arena to add the tree's Nodes to
+// Returns:    The index of the Node at the root of the tree we have just built
 // Does:       Alternative way to reduce the runtime of the build_tree_best
 //             function, here we track the sums of the number of entries for
 //             which the answer is yes and update these sums as entries are 
@@ -482,76 +991,284 @@ KDtree::Node *KDtree::build_tree_sample(vector<int> pool)
 //             half of the pool. This function is split into an overloaded 
 //             recursive function, and this function which calls it at the 
 //             starting pool and staring sums vectors
-KDtree::Node *KDtree::build_tree_sums(vector<int> pool) 
+uint32_t KDtree::build_tree_sums(uint32_t begin, uint32_t end, 
+                                 vector<Node> &arena) 
 {
     // Make a second vector parallel to that of the questions, this vector is
     // of type integer and each index contains the total number of entries in 
     // the pool for which that question is true.
-    vector<int> sums(questions.size(), 0);
-
-    for (size_t i = 0; i < entries.size(); i++) {
-        for (size_t j = 0; j < entries[i].answers.size(); j++) {
-            sums[j] += entries[i].answers[j];
-        }
-    }
+    vector<int> sums;
+    count_pool_yes(&order[begin], end - begin, sums);
 
     // Now we pass the starting pool and the parallel vector of sums to the 
     // overloaded recursive function build_tree_sums
-    return build_tree_sums(pool, sums);
+    return build_tree_sums(begin, end, sums, arena);
 }
 
 // Function build_tree_sums
-// Parameters: Two vectors of integers: pool and q_sums
-// Returns:    A pointer to a Node
+// Parameters: The range [begin, end) of the order vector that holds the pool,
+//             a vector of integers, q_sums, passed by reference, and the 
+//             arena to add the subtree's Nodes to
+// Returns:    The index of a Node
 // Does:       Overloaded recursive version of build_tree_sums that tracks
 //             the sums of entries for which each question is correct as well 
-//             as the pool of entries themselves. We no longer have to interate
-//             through each of the entries' answers vector, we can just iterate
-//             through the q_sums vector to find the most polarizing question
-KDtree::Node *KDtree::build_tree_sums(vector<int> pool, vector<int> q_sums)
-{
-    if (pool.size() < 1) {
-        return nullptr;
-    } else if (pool.size() == 1) {
-        Node *new_node = make_node(pool[0]);
-        return new_node; 
+//             as the pool of entries themselves. Once the pool is divided, 
+//             only the smaller of the two pools is counted, and the larger 
+//             pool's sums are what is left when those counts are taken away 
+//             from q_sums, in place. An entry is only ever counted as part of
+//             a pool at most half the size of the last pool that counted it,
+//             so each entry is counted O(log N) times over the whole build,
+//             however deep the tree is. q_sums is used up by the call. A pool
+//             that no question divides is left together in a leaf
+uint32_t KDtree::build_tree_sums(uint32_t begin, uint32_t end, 
+                                 vector<int> &q_sums, vector<Node> &arena)
+{
+    if (end - begin < 1) {
+        return NO_NODE;
+    } else if (end - begin == 1) {
+        return make_node(begin, arena);
     } else {
-        int best_index = select_best_sum(q_sums, pool.size());
-        Node *new_node = make_node(pool, best_index);
-
-        vector<int> yes_pool, no_pool, yes_sums(questions.size(), 0);
-        for (size_t i = 0; i < pool.size(); i++) {
-            if (entries[pool[i]].answers[best_index] == 1) {
-                yes_pool.push_back(pool[i]);
-                for (size_t j = 0; j < entries[pool[i]].answers.size(); j++) {
-                    // Remove the entry's contribution to the q_sums and add 
-                    // one to the yes_sums
-                    yes_sums[j] += entries[pool[i]].answers[j];
-                    q_sums[j] -= entries[pool[i]].answers[j];
-                }
-            } else {
-                no_pool.push_back(pool[i]);
-            }
+        int best_index = select_best_sum(q_sums, end - begin);
+        uint32_t middle = partition_pool(begin, end, best_index);
+        if (middle == begin or middle == end) {
+            return make_node(begin, end, -1, arena);
         }
-        new_node->yes = build_tree_sums(yes_pool, yes_sums);
-        new_node->no = build_tree_sums(no_pool, q_sums);
+        uint32_t new_node = make_node(begin, end, best_index, arena);
+
+        bool yes_smaller = middle - begin <= end - middle;
+        uint32_t small_begin = yes_smaller ? begin : middle;
+        uint32_t small_end = yes_smaller ? middle : end;
+        vector<int> small_sums;
+        count_pool_yes(&order[small_begin], small_end - small_begin, 
+                       small_sums);
+        subtract_counts(q_sums.data(), small_sums.data(), num_questions);
+
+        vector<int> &yes_sums = yes_smaller ? small_sums : q_sums;
+        vector<int> &no_sums = yes_smaller ? q_sums : small_sums;
+        fork_join(end - begin, arena, new_node,
+                  [&](vector<Node> &a) { 
+                      return build_tree_sums(begin, middle, yes_sums, a); },
+                  [&](vector<Node> &a) { 
+                      return build_tree_sums(middle, end, no_sums, a); });
         return new_node;
     }
 }
 
+// Function at
+// Parameters: The index of a Node
+// Returns:    A copy of the Node
+// Does:       In a lazy tree, first expands the Node if it has not been 
+//             expanded yet. The Node is copied while expand_lock is held, 
+//             because the speculating thread may grow the arena at any time
+KDtree::Node KDtree::at(uint32_t index)
+{
+    if (not lazy) {
+        return node_array[index];
+    }
+    lock_guard<mutex> guard(expand_lock);
+    if (is_unexpanded(nodes[index])) {
+        expand(index);
+    }
+    return nodes[index];
+}
+
+// Function first_entry_at
+// Parameters: The index of a Node
+// Returns:    The index of the first entry in the Node's pool
+// Does:       Reads the order while holding expand_lock in a lazy tree, since
+//             the speculating thread may be partitioning the pool of one of
+//             the Node's children
+int KDtree::first_entry_at(uint32_t index)
+{
+    if (not lazy) {
+        return order_array[node_array[index].begin];
+    }
+    lock_guard<mutex> guard(expand_lock);
+    return order[nodes[index].begin];
+}
+
+// Function node_count
+// Parameters: None
+// Returns:    The number of Nodes in the tree so far, which in a lazy tree
+//             grows as Nodes are expanded
+uint32_t KDtree::node_count()
+{
+    if (mapped != nullptr) {
+        return mapped->num_nodes();
+    } else if (not lazy) {
+        return static_cast<uint32_t>(nodes.size());
+    }
+    lock_guard<mutex> guard(expand_lock);
+    return static_cast<uint32_t>(nodes.size());
+}
+
+// Function speculate_loop
+// Parameters: None
+// Returns:    None
+// Does:       Body of the speculating thread of a lazy tree. Sleeps until a
+//             Node is handed to it by move_to, then expands that Node and 
+//             both of its children. Gives up on the children if a newer Node
+//             is handed to it in the meantime. Returns once the tree is being
+//             destroyed
+void KDtree::speculate_loop()
+{
+    unique_lock<mutex> guard(expand_lock);
+    while (true) {
+        speculate_wake.wait(guard, [this]() { 
+            return stopping or speculate_target != NO_NODE; });
+        if (stopping) {
+            return;
+        }
+        uint32_t target = speculate_target;
+        speculate_target = NO_NODE;
+        if (is_unexpanded(nodes[target])) {
+            expand(target);
+        }
+
+        uint32_t children[2] = { nodes[target].yes, nodes[target].no };
+        for (int i = 0; i < 2; i++) {
+            if (stopping or speculate_target != NO_NODE) {
+                break;
+            }
+            if (children[i] != NO_NODE and is_unexpanded(nodes[children[i]])) {
+                expand(children[i]);
+            }
+            // Gives the game a chance to take the lock between expansions
+            guard.unlock();
+            this_thread::yield();
+            guard.lock();
+        }
+    }
+}
+
+// Function is_unexpanded
+// Parameters: A Node, passed by reference
+// Returns:    A bool, true if the Node's pool has more than one entry but it
+//             has no children yet, and it is not a leaf, which only happens 
+//             in a lazy tree
+bool KDtree::is_unexpanded(const Node &node)
+{
+    return node.end - node.begin > 1 and node.yes == NO_NODE and 
+           node.no == NO_NODE and node.question != -1;
+}
+
+// Function make_lazy_node
+// Parameters: The range [begin, end) of the order vector that holds a pool,
+//             and, for version 0.0, the index of the question to ask of it
+// Returns:    The index of the new Node, or NO_NODE for an empty pool
+// Does:       Makes a leaf for a pool of one entry, and an unexpanded Node 
+//             for a larger pool, which is split by expand when it is first 
+//             reached. In version 0.0, a pool that every question has been 
+//             asked of is a leaf as well
+uint32_t KDtree::make_lazy_node(uint32_t begin, uint32_t end, int q_num)
+{
+    if (end - begin < 1) {
+        return NO_NODE;
+    } else if (end - begin == 1) {
+        return make_node(begin, nodes);
+    } else if (tree_version != 0.0) {
+        return make_node(begin, end, UNEXPANDED, nodes);
+    } else if (static_cast<size_t>(q_num) >= num_questions) {
+        return make_node(begin, end, -1, nodes);
+    } else {
+        return make_node(begin, end, q_num, nodes);
+    }
+}
+
+// Function expand
+// Parameters: The index of an unexpanded Node
+// Returns:    None
+// Does:       Does for one Node what the build function of this tree's 
+//             version does at every Node: chooses the question to ask of its
+//             pool in the same way, partitions the pool by it, and makes the
+//             two children, unexpanded. The tree that is expanded this way is
+//             the same tree that would have been built up front, including 
+//             the leaves of pools that no question divides. Must be called
+//             with expand_lock held
+void KDtree::expand(uint32_t index)
+{
+    uint32_t begin = nodes[index].begin;
+    uint32_t end = nodes[index].end;
+    size_t pool_size = end - begin;
+    int q_index;
+
+    if (tree_version == 0.0) {
+        q_index = nodes[index].question;
+    } else if (tree_version == 1.5) {
+        vector<int> &counts = scratch().yes_counts;
+        count_pool_yes(&order[begin], pool_size, counts);
+        q_index = select_best_sum(counts, pool_size);
+    } else if ((tree_version == 1.1 or tree_version == 3.0) and 
+               pool_size > build_options.sample_size) {
+        q_index = select_sample_question(begin, end);
+    } else {
+        q_index = select_best_question(&order[begin], pool_size);
+    }
+
+    uint32_t middle = partition_pool(begin, end, q_index);
+    if (tree_version != 0.0 and (middle == begin or middle == end)) {
+        // Only a sampled question is chosen again from the whole pool, as
+        // build_tree_sample does, so that the pool is partitioned as many
+        // times as it is up front, and its leaf's order is the same
+        if ((tree_version == 1.1 or tree_version == 3.0) and
+            pool_size > build_options.sample_size) {
+            q_index = select_best_question(&order[begin], pool_size);
+            middle = partition_pool(begin, end, q_index);
+        }
+        if (middle == begin or middle == end) {
+            nodes[index].question = -1;
+            return;
+        }
+    }
+    uint32_t yes_child = make_lazy_node(begin, middle, q_index + 1);
+    uint32_t no_child = make_lazy_node(middle, end, q_index + 1);
+    nodes[index].question = q_index;
+    nodes[index].yes = yes_child;
+    nodes[index].no = no_child;
+    node_array = nodes.data();
+}
+
+// Function partition_pool
+// Parameters: The range [begin, end) of the order vector that holds a pool,
+//             and the index of the question to divide it by
+// Returns:    The index, middle, where the no-pool starts
+// Does:       Rearranges the range in place, in the fashion of the partition
+//             step of quicksort, so that the entries that answer yes to the 
+//             question are in [begin, middle) and those that answer no are in
+//             [middle, end). This way the yes-pool and no-pool of every Node 
+//             are ranges of one shared vector rather than vectors of their own
+uint32_t KDtree::partition_pool(uint32_t begin, uint32_t end, int q_index)
+{
+    uint32_t middle = begin;
+    uint32_t last = end;
+    while (middle < last) {
+        if (data->answers().get(order[middle], q_index)) {
+            middle++;
+        } else {
+            last--;
+            int temp = order[middle];
+            order[middle] = order[last];
+            order[last] = temp;
+        }
+    }
+    return middle;
+}
+
 // Function select_best_sums
-// Parameters: A vector of integers, q_sums, whose elements are the sums of 
-//             entries for which the answer is correct for each question, and
+// Parameters: A vector of integers, q_sums, passed by reference, whose 
+//             elements are the sums of entries for which the answer is 
+//             correct for each question, and
 //             the size of the current pool of entries, as an unsigned 
 // Returns:    An integer, the idex of the most polarizing question
 // Does:       Returns the index of the most polarizing question which is the
 //             index in the q_sums vector whose value is closest to half of the
 //             pool_size   
-int KDtree::select_best_sum(vector<int> q_sums, size_t pool_size) 
+int KDtree::select_best_sum(const vector<int> &q_sums, size_t pool_size) 
 {
-    double half_of_pool = pool_size / 2;
+    double half_of_pool = static_cast<double>(pool_size) / 2;
     int best_index = 0;
     double best_difference = pool_size;
+    runStats::add(runStats::QUESTIONS_SCORED, q_sums.size());
 
     // Similar procedure to finding the maximum or minimum element in a vector
     // But the exception is that here, we are trying to minimize the difference
@@ -567,51 +1284,99 @@ int KDtree::select_best_sum(vector<int> q_sums, size_t pool_size)
     return best_index;
 }
 
-// Function make_sample_set
-// Parameters: Two vectors of integers, passed by reference. The given pool of
-//             indices of entries and the sample set of that pool
-// Returns:    None
-// Does:       Randomly chooses a sample set of 10 from the given pool of 
-//             indices, assumes that the size of the pool is 10 or greater
-void KDtree::make_sample_set(vector<int> &sample_set, vector<int> &pool)
+// Function select_sample_question
+// Parameters: The range [begin, end) of the order vector that holds a pool
+//             larger than the sample size
+// Returns:    An integer, the index of the question that best splits a 
+//             random sample of the pool
+// Does:       Draws the sample by a partial Fisher-Yates shuffle of the pool
+//             in place, so the sample is the first k entries of the range and
+//             drawing it takes O(k) time with nothing copied. The shuffle is
+//             driven by a generator seeded from the build's seed and the 
+//             range itself, so the same seed builds the same tree, whichever
+//             thread builds which subtree. Starting from the configured 
+//             sample size, the best question of the sample is chosen, and 
+//             the share of the sample that answers it yes estimates the share
+//             of the pool that will. While the 95% confidence interval of 
+//             that estimate is wider than the sample tolerance either side, 
+//             the sample is doubled by carrying on the same shuffle, and the
+//             question is chosen again. A tolerance of zero keeps the sample 
+//             at its configured size
+int KDtree::select_sample_question(uint32_t begin, uint32_t end)
 {
-    vector<int> clone;
-    for (size_t i = 0; i < pool.size(); i++) {
-        clone.push_back(pool[i]);
-    }
+    size_t pool_size = end - begin;
+    uint64_t state = build_options.seed ^ 
+                     (static_cast<uint64_t>(begin) << 32 | end);
+    size_t drawn = 0;
+    size_t sample_size = build_options.sample_size;
+    vector<int> &yes_counts = scratch().yes_counts;
+
+    while (true) {
+        if (sample_size > pool_size) {
+            sample_size = pool_size;
+        }
+        for (; drawn < sample_size; drawn++) {
+            uint64_t choice = (static_cast<unsigned __int128>(
+                                   next_random(state)) * 
+                               (pool_size - drawn)) >> 64;
+            size_t pick = begin + drawn + choice;
+            int temp = order[begin + drawn];
+            order[begin + drawn] = order[pick];
+            order[pick] = temp;
+        }
 
-    for (int i = 0; i < 10; i++) {
-        size_t random_index = rand() % clone.size();
-        sample_set.push_back(clone[random_index]);
-        vector<int>::iterator to_remove;
-        to_remove = clone.begin();
-        to_remove += random_index;
-        clone.erase(to_remove);
+        int best_index = select_best_question(&order[begin], sample_size);
+        if (build_options.sample_tolerance <= 0 or sample_size == pool_size) {
+            return best_index;
+        }
+
+        // The standard error of a share drawn without replacement
+        double share = static_cast<double>(yes_counts[best_index]) / 
+                       sample_size;
+        double error = sqrt(share * (1 - share) / sample_size *
+                            (pool_size - sample_size) / (pool_size - 1));
+        if (1.96 * error <= build_options.sample_tolerance) {
+            return best_index;
+        }
+        sample_size *= 2;
     }
 }
 
+// Function next_random
+// Parameters: The state of a generator, passed by reference
+// Returns:    The next 64 random bits
+// Does:       Steps a splitmix64 generator, which is small enough to seed
+//             afresh for every pool and passes the usual statistical tests
+uint64_t KDtree::next_random(uint64_t &state)
+{
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
 // Function select_best_question
-// Parameters: A vector of integers, pool, the indices of entries
+// Parameters: A pointer to the indices of the entries in a pool, and the 
+//             number of entries in the pool
 // Returns:    An integer, the index of the best question to ask in order to
 //             divide the pool roughly in half
-// Does:       Iterates through all of the questions and all of the entries,
-//             adding up the number of entries that are correct for each
-//             question and tracking the index of the question that has a sum
-//             of indices closest to half of the pool's size. Then returns that
+// Does:       Counts the number of entries in the pool that are correct for
+//             each question, then tracks the index of the question that has 
+//             a count closest to half of the pool's size. Then returns that
 //             index
-int KDtree::select_best_question(vector<int> pool) 
+int KDtree::select_best_question(const int *pool, size_t pool_size) 
 {
     int best_question_index = 0;
     int best_question_yes = 0;
-    double half_of_pool = static_cast<double>(pool.size()) / 2;
+    double half_of_pool = static_cast<double>(pool_size) / 2;
 
-    for (size_t i = 0; i < questions.size(); i++) {
-        int number_yes = 0;
-        for (size_t j = 0; j < pool.size(); j++) {
-            if (entries[pool[j]].answers[i] == 1) {
-                number_yes++;
-            }
-        }
+    vector<int> &yes_counts = scratch().yes_counts;
+    count_pool_yes(pool, pool_size, yes_counts);
+    runStats::add(runStats::QUESTIONS_SCORED, num_questions);
+
+    for (size_t i = 0; i < num_questions; i++) {
+        int number_yes = yes_counts[i];
 
         double current_difference = abs(number_yes - half_of_pool);
         double target_difference = abs(best_question_yes - half_of_pool);
@@ -625,45 +1390,109 @@ int KDtree::select_best_question(vector<int> pool)
     return best_question_index;
 }
 
+// Function count_pool_yes
+// Parameters: A pointer to the indices of the entries in a pool, the number 
+//             of entries in the pool, and a vector of integers, counts, 
+//             passed by reference
+// Returns:    None
+// Does:       Sets counts[i] to the number of entries in the pool whose 
+//             answer to question i is yes. When the pool is dense enough that
+//             it has, on average, at least COLUMN_DENSITY entries in every 
+//             word of the span it covers, the pool is marked in this thread's
+//             pool bitset and every question's column is ANDed and popcounted
+//             against it. Only the bits that were set are cleared again 
+//             afterwards, so the bitset stays zeroed between calls without 
+//             being rewritten in full. Sparser pools are counted from their
+//             entries' rows instead, with bit-sliced counters unless the pool
+//             is so small that adding up the rows one at a time is quicker
+void KDtree::count_pool_yes(const int *pool, size_t pool_size, 
+                            vector<int> &counts)
+{
+    if (pool_size == 0) {
+        counts.assign(num_questions, 0);
+        return;
+    }
+
+    runStats::add(runStats::ANSWERS_COUNTED, pool_size * num_questions);
+    const answerMatrix &answers = data->answers();
+    int lowest = pool[0], highest = pool[0];
+    for (size_t j = 1; j < pool_size; j++) {
+        if (pool[j] < lowest) {
+            lowest = pool[j];
+        } else if (pool[j] > highest) {
+            highest = pool[j];
+        }
+    }
+    size_t first_word = lowest >> 6;
+    size_t last_word = (highest >> 6) + 1;
+
+    if ((last_word - first_word) * COLUMN_DENSITY <= pool_size) {
+        vector<uint64_t> &pool_bits = scratch().pool_bits;
+        for (size_t j = 0; j < pool_size; j++) {
+            pool_bits[pool[j] >> 6] |= static_cast<uint64_t>(1) 
+                                       << (pool[j] & 63);
+        }
+        answers.count_yes(pool_bits.data(), first_word, last_word, 
+                          num_questions, counts);
+        for (size_t j = 0; j < pool_size; j++) {
+            pool_bits[pool[j] >> 6] = 0;
+        }
+    } else if (pool_size >= ROW_SLICING_MIN) {
+        counts.resize(num_questions);
+        count_yes_rows(answers.row(0), answers.words_per_row(), pool, 
+                       pool_size, num_questions, counts.data());
+    } else {
+        counts.assign(num_questions, 0);
+        for (size_t j = 0; j < pool_size; j++) {
+            add_row_counts(answers.row(pool[j]), num_questions, 
+                           counts.data());
+        }
+    }
+}
+
 // Function make_node
-// Parameters: An integer, data, an index of the single remaining correct entry
-//             in the pool
-// Returns:    A pointer to a Node, newly initialized 
+// Parameters: The position, begin, in the order vector of the single 
+//             remaining correct entry in the pool, and the arena to add the 
+//             Node to
+// Returns:    The index of the newly initialized Node in the arena
 // Does:       Overloaded make node function for making a leaf node where there
-//             is only one index in the correct entries vector, and the 
-//             question member variable is set to the string " ", signifying 
-//             that there is no question to ask here, for there is no need to
-//             divide the pool any further
-KDtree::Node *KDtree::make_node(int data)
+//             is only one entry in the pool, and the question member variable
+//             is set to -1, signifying that there is no question to ask here,
+//             for there is no need to divide the pool any further
+uint32_t KDtree::make_node(uint32_t begin, vector<Node> &arena)
 {
-    Node *new_node = new Node;
-    new_node->yes = nullptr;
-    new_node->no = nullptr;
-    new_node->question = " ";
-    new_node->correct_entries.push_back(data);
-    return new_node;
+    Node new_node;
+    new_node.yes = NO_NODE;
+    new_node.no = NO_NODE;
+    new_node.question = -1;
+    new_node.begin = begin;
+    new_node.end = begin + 1;
+    arena.push_back(std::move(new_node));
+    runStats::add(runStats::NODES_MADE);
+    return static_cast<uint32_t>(arena.size() - 1);
 }
 
 // Function make_node
-// Parameters: A vector of integers, pool, the indices which the correct entry
-//             could be, and an index of a question 
-// Returns:    A pointer to a Node, newly allocated on the heap
-// Does:       An overloaded make_node function that stores a vector of indices
-//             as the correct entries vector and sets the question member 
-//             variable to the question at the given index. Initializes both
-//             yes and no pointers to the nullptr
-KDtree::Node *KDtree::make_node(vector<int> pool, int q_index) 
+// Parameters: The range [begin, end) of the order vector that holds the 
+//             indices which the correct entry could be, an index of a 
+//             question, and the arena to add the Node to
+// Returns:    The index of the newly initialized Node in the arena
+// Does:       An overloaded make_node function that stores the range of the
+//             pool and sets the question member variable to the given 
+//             question index. Initializes both yes and no children to 
+//             NO_NODE
+uint32_t KDtree::make_node(uint32_t begin, uint32_t end, int q_index, 
+                           vector<Node> &arena) 
 {
-    Node *new_node = new Node;
-    new_node->question = questions[q_index].question;
-
-    for (size_t i = 0; i < pool.size(); i++) {
-        new_node->correct_entries.push_back(pool[i]);
-    }
-
-    new_node->yes = nullptr;
-    new_node->no = nullptr;
-    return new_node;
+    Node new_node;
+    new_node.question = q_index;
+    new_node.begin = begin;
+    new_node.end = end;
+    new_node.yes = NO_NODE;
+    new_node.no = NO_NODE;
+    arena.push_back(std::move(new_node));
+    runStats::add(runStats::NODES_MADE);
+    return static_cast<uint32_t>(arena.size() - 1);
 }
 
 
@@ -687,10 +1516,10 @@ void KDtree::print_Es()
 {
     cout << "Printing Entries:" << endl;
 
-    for (size_t i = 0; i < entries.size(); i++) {
-        cout << entries[i].name << endl;
-        for (size_t j = 0; j < entries[i].answers.size(); j++) {
-            cout << entries[i].answers[j] << " ";
+    for (size_t i = 0; i < data->num_entries(); i++) {
+        cout << data->entry_name(i) << endl;
+        for (size_t j = 0; j < data->answers().num_questions(); j++) {
+            cout << data->answers().get(i, j) << " ";
         }
         cout << endl;
     }
@@ -706,8 +1535,8 @@ void KDtree::print_Qs()
 {
     cout << "Printing Questions:" << endl;
 
-    for (size_t i = 0; i < questions.size(); i++) {
-        cout << questions[i].question << endl;
+    for (size_t i = 0; i < data->num_questions(); i++) {
+        cout << data->question(i) << endl;
     }
 
     cout << endl;
@@ -1,16 +1,36 @@
 // KDtree.h
 // By: Miles Izydorczak
 // Date: 19 November 2019
-// Purpose: Interface of the KDtree class. This class contains a tree with two
-//          ways of accessing. One is the root Node and the other is a current
-//          Node which can be advanced and reset as needed to traverse the tree
-//          The rest of this class's functionality goes into different ways to
-//          construct this tree.
+// Purpose: Interface of the KDtree class. This class contains a tree that is
+//          never changed once it is built, and is played on through 
+//          GameCursors, each of which holds a current Node that can be 
+//          advanced and reset as needed to traverse the tree, along with the
+//          answers of its game, so that many games can share one tree. The 
+//          rest of this class's functionality goes into different ways to
+//          construct this tree. The Nodes are kept in a single vector, the
+//          arena, and refer to their children by their index in it. The pool
+//          of every Node is a range of a single vector of entry indices, the
+//          order, which is partitioned in place as the tree is built. A
+//          built tree can be written to a treeFile, and a KDtree can be made
+//          from a mapped treeFile, in which case the game is played straight
+//          from the mapped Nodes and order without building anything. A
+//          lazy tree makes only its root up front, and expands every other
+//          Node when a game first reaches it, while a speculating thread
+//          expands the children of the Node that a game has just reached
 //
 
 #include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
 #include "questions_and_entries.h"
-#include "Stack.h"
+#include "answerMatrix.h"
+#include "dataset.h"
+#include "options.h"
+#include "taskPool.h"
+#include "treeFile.h"
 #include "userInput.h"
 
 using namespace std;
@@ -19,71 +39,174 @@ using namespace std;
 #define _KDTREE_H_
 
 class KDtree {
+    struct Probably {
+        bool yes;
+        uint32_t prob_node;
+    };
+
+    struct Unknown {
+        bool yes;
+        uint32_t unkwn_node;
+    };
+
 public:
-    KDtree(vector<Entry> &eVec, vector<Question> &qVec, double vers);
-    ~KDtree();
+    // The state of one game played on the tree: the Node that it has reached,
+    // the probablies and unknowns that it can return to, and the answers 
+    // that the player has given. The tree itself is never changed by a game.
+    // The state can be saved to a few bytes and restored into a cursor of 
+    // the same tree, or of a tree built the same way in another process
+    class GameCursor {
+    public:
+        void reset();
+
+        void advance(bool yes);
+        void advance_probably(userInput input);
+        bool return_to_probably();
+
+        int size_of_pool();
+        bool can_ask();
+        string entry_at_curr();
+        string question_at_curr();
+        int question_index_at_curr();
+
+        void save(string &state);
+        bool restore(const string &state, size_t &at);
+
+    private:
+        friend class KDtree;
+
+        KDtree *tree;
+        uint32_t curr;
+
+        vector<Probably> probablies;
+        vector<Unknown> unknowns;
+        // The player's answers in this game, one bit per question
+        vector<uint64_t> answered;
+        vector<uint64_t> answered_yes;
+        vector<uint64_t> answered_maybe;
+
+        void move_to(uint32_t index);
+        void add_probably(bool yes);
+        void add_unknown();
+        void clear_answers();
+        void set_question_truth(int q_index, userInput UI);
+        userInput question_truth(int q_index);
+        static bool test_bit(const vector<uint64_t> &bits, size_t index);
+        static void set_bit(vector<uint64_t> &bits, size_t index, 
+                            bool value);
+        void skip_answered_questions();
+    };
 
-    void print_input();
+    KDtree(shared_ptr<const dataset> data, double vers);
+    KDtree(shared_ptr<const dataset> data, double vers, 
+           BuildOptions &options);
+    KDtree(treeFile &file);
+    ~KDtree();
 
-    void reset();
+    void write_file(string filename, string prompt, double version);
 
-    void advance(bool yes);
-    void advance_probably(userInput input);
-    bool return_to_probably();
+    void print_input();
 
-    int size_of_pool();
-    string entry_at_curr();
-    string question_at_curr();
+    GameCursor start_game();
 
 private:
-    vector<Question> questions;
-    vector<Entry> entries;
+    // The microbenchmarks time the kernels that choose questions
+    friend class treeBench;
+
+    // The entries, questions and answers that the tree is built from, which
+    // are shared with the rest of the game, or nullptr when the tree is 
+    // played from a treeFile
+    shared_ptr<const dataset> data;
+    size_t num_questions;
 
     void print_Qs();
     void print_Es();
 
     struct Node {
-        string question;
-        vector<int> correct_entries;
-        Node *yes;
-        Node *no;
-    };
-
-    Node *root;
-    Node *curr;
-
-    struct Probably {
-        bool yes;
-        Node *prob_ptr;
+        // Index of the question asked here, or -1 at a leaf, whose pool holds
+        // one entry, or several entries that no question tells apart
+        int32_t question;
+        // The pool of correct entries is order[begin] to order[end - 1]
+        uint32_t begin;
+        uint32_t end;
+        uint32_t yes;
+        uint32_t no;
     };
 
-    struct Unknown {
-        bool yes;
-        Node *unkwn_ptr;
+    // Index that stands for "no node", in place of the nullptr
+    static const uint32_t NO_NODE = 0xFFFFFFFF;
+    // The question of a Node of a lazy tree that has not been expanded yet,
+    // except in version 0.0, where it is the question to expand it by
+    static const int32_t UNEXPANDED = -2;
+
+    vector<Node> nodes;
+    vector<int> order;
+    // The Nodes and order that the game is played on, which are either the
+    // two vectors above or the sections of a mapped treeFile
+    const Node *node_array;
+    const int *order_array;
+    treeFile *mapped;
+    uint32_t root;
+
+    // A lazy tree's speculating thread, and the lock that it and the game 
+    // hold while expanding Nodes or reading the arena
+    double tree_version;
+    bool lazy;
+    thread speculator;
+    mutex expand_lock;
+    condition_variable speculate_wake;
+    uint32_t speculate_target;
+    bool stopping;
+
+    Node at(uint32_t index);
+    int first_entry_at(uint32_t index);
+    uint32_t node_count();
+    void speculate(uint32_t index);
+    void speculate_loop();
+    bool is_unexpanded(const Node &node);
+    uint32_t make_lazy_node(uint32_t begin, uint32_t end, int q_num);
+    void expand(uint32_t index);
+
+    int select_sample_question(uint32_t begin, uint32_t end);
+    static uint64_t next_random(uint64_t &state);
+
+    struct Scratch {
+        vector<uint64_t> pool_bits;
+        vector<int> yes_counts;
     };
 
-    Stack<Probably> probablies;
-    Stack<Unknown> unknowns;
-
-    void add_probably(bool yes);
-    void add_unknown();
-    void set_question_truth(string questionStr, userInput UI);
-    void skip_answered_questions();
-
-    void make_sample_set(vector<int> &sample_set, vector<int> &pool);
-
-    int select_best_question(vector<int> pool);
-    int select_best_sum(vector<int> q_sums, size_t pool_size);
-
-    Node *build_tree(double version);
-    Node *delete_tree(Node *node);
-    Node *build_tree_order(vector<int> pool, int q_num);
-    Node *build_tree_best(vector<int> pool);
-    Node *build_tree_sample(vector<int> pool);
-    Node *build_tree_sums(vector<int> pool);
-    Node *build_tree_sums(vector<int> pool, vector<int> q_sums);
-    Node *make_node(vector<int> pool, int q_index);
-    Node *make_node(int data);
+    BuildOptions build_options;
+    taskPool *workers;
+
+    void init(shared_ptr<const dataset> data, double vers);
+    void check_mapped_nodes(treeFile &file);
+    Scratch &scratch();
+    typedef function<uint32_t(vector<Node> &)> subtreeTask;
+    void fork_join(size_t pool_size, vector<Node> &arena, uint32_t parent,
+                   subtreeTask yes_task, subtreeTask no_task);
+    uint32_t append_subtree(vector<Node> &arena, vector<Node> &subtree,
+                            uint32_t subtree_root);
+
+    int select_best_question(const int *pool, size_t pool_size);
+    void count_pool_yes(const int *pool, size_t pool_size, 
+                        vector<int> &counts);
+    int select_best_sum(const vector<int> &q_sums, size_t pool_size);
+
+    uint32_t build_tree(double version);
+    uint32_t build_tree_order(uint32_t begin, uint32_t end, int q_num, 
+                              vector<Node> &arena);
+    uint32_t build_tree_best(uint32_t begin, uint32_t end, 
+                             vector<Node> &arena);
+    uint32_t build_tree_sample(uint32_t begin, uint32_t end, 
+                               vector<Node> &arena);
+    uint32_t build_tree_sums(uint32_t begin, uint32_t end, 
+                             vector<Node> &arena);
+    uint32_t build_tree_sums(uint32_t begin, uint32_t end, 
+                             vector<int> &q_sums, vector<Node> &arena);
+    uint32_t partition_pool(uint32_t begin, uint32_t end, int q_index);
+    uint32_t make_node(uint32_t begin, uint32_t end, int q_index, 
+                       vector<Node> &arena);
+    uint32_t make_node(uint32_t begin, vector<Node> &arena);
 };
 
 #endif
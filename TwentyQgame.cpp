@@ -13,11 +13,20 @@
 #include <fstream>
 #include <cstdlib>
 #include <sstream>
+#include <chrono>
 #include "KDtree.h"
 #include "TwentyQgame.h"
 #include "questions_and_entries.h"
+#include "answerMatrix.h"
 #include "userInput.h"
 #include "hammingTrie.h"
+#include "treeFile.h"
+#include "datasetFile.h"
+#include "entriesParser.h"
+#include "gameSession.h"
+#include "gameServer.h"
+#include "selfPlay.h"
+#include "runStats.h"
 
 using namespace std;
 
@@ -31,231 +40,257 @@ using namespace std;
 //       functions to use to play the actual game.
 TwentyQgame::TwentyQgame(string version, string entriesFile, string qsFile)
 {
+    tree_file = nullptr;
+    tree = nullptr;
+    neighborhood = nullptr;
+    runStats::Timer loading(runStats::LOAD);
     read_entries(entriesFile);
     read_questions(qsFile);
+    share_dataset(true);
     set_version_num(version);
 }
 
-// Function run
-// Parameters: None
-// Returns:    None
-// Does:       Using the version_num data member, calls the appropriate run
-//             function.
-void TwentyQgame::run() 
+// Constructor TwentyQgame
+// Does: The same as the constructor above, but also keeps the given 
+//       BuildOptions, which are passed on to every KDtree that the game 
+//       builds
+TwentyQgame::TwentyQgame(string version, string entriesFile, string qsFile,
+                         BuildOptions &options)
 {
-    run_welcome();
-    if (version_num < 2.0) {
-        run_proto();   
-    } else if (version_num == 2.0) {
-        run_prob();
-    } else if (version_num == 3.0) {
-        run_neighbors();
-    } else if (version_num == 4.0) {
-        run_hybrid();
-    } else {
-        run_neural();
-    }
+    build_options = options;
+    tree_file = nullptr;
+    tree = nullptr;
+    neighborhood = nullptr;
+    runStats::Timer loading(runStats::LOAD);
+    read_entries(entriesFile);
+    read_questions(qsFile);
+    share_dataset(true);
+    set_version_num(version);
 }
 
-// Function run_welcome
-// Parameters: None
-// Returns:    None
-// Does:       Prints an instructional message to standard output, the contents
-//             of which vary in accordance to the version which we are running
-//             Then waits for the user to enter B to begin as they think of 
-//             an entry for the program to guess, printing acknowledgements if
-//             they are asked for.
-void TwentyQgame::run_welcome() 
+// Constructor TwentyQgame
+// Does: The same as the constructor above, but reads the entries, questions
+//       and answers from a binary dataset file written by convert, rather
+//       than from the two text files
+TwentyQgame::TwentyQgame(string version, string datasetFileName,
+                         BuildOptions &options)
 {
-    if (version_num != 2.0) {
-        cout << "Welcome to 20 questions! Please think of a(n)\n" 
-             << prompt << endl 
-             << "Respond to each of the following questions with (y/n)\n";
-    } else if (version_num == 2.0) {
-        cout << "Welcome to 20 questions! Please think of a(n)\n"
-             << prompt << endl
-             << "Respond to each of the following questions with "
-                "(y/n/prob/probnot/unknown)\n";
-    }
+    build_options = options;
+    tree_file = nullptr;
+    tree = nullptr;
+    neighborhood = nullptr;
+    runStats::Timer loading(runStats::LOAD);
+    read_dataset(datasetFileName);
+    share_dataset(true);
+    set_version_num(version);
+}
 
-    char command;
-    bool repeat = true;
-    while (repeat) {
-        cout << "Type B to begin or I for more information" << endl;
-        cin >> command;
-        if (command == 'B') {
-            return;
-        } else if (command == 'I') {
-            cout << ACKNOWLEDGEMENTS << endl;
-        }
+// Constructor TwentyQgame
+// Does: Sets up a game that is played on a tree compiled ahead of time by
+//       compile. Rather than reading and building anything, it maps the tree
+//       file, and takes the version number and the prompt from it
+TwentyQgame::TwentyQgame(string treeFileName, BuildOptions &options)
+{
+    build_options = options;
+    runStats::Timer loading(runStats::LOAD);
+    tree_file = new treeFile;
+    tree_file->map(treeFileName);
+    tree = nullptr;
+    neighborhood = nullptr;
+    version_num = tree_file->version();
+    prompt = tree_file->prompt();
+}
+
+// Destructor ~TwentyQgame
+// Does: Recycles the tree of the last game and the neighbor index, once it 
+//       has finished being built, and unmaps the tree file, if there is one
+TwentyQgame::~TwentyQgame()
+{
+    if (neighborhood_builder.joinable()) {
+        neighborhood_builder.join();
     }
+    delete neighborhood;
+    delete tree;
+    delete tree_file;
 }
 
-// Function run_proto()
-// Parameters: None
+// Constructor TwentyQgame
+// Does: Sets up an empty game, for convert to read the text files into
+TwentyQgame::TwentyQgame()
+{
+    tree_file = nullptr;
+    tree = nullptr;
+    neighborhood = nullptr;
+    version_num = 0.0;
+}
+
+// Function convert
+// Parameters: The names of an entries file and a questions file, and the name
+//             of the dataset file to write
 // Returns:    None
-// Does:       Navegates the tree structure made from an instance of the KDtree
-//             class by asking for a character from standard input, either 'y'
-//             or 'n', then advances in that direction until there is just one
-//             entry that it has narrowed the pool to. It asks if the user was
-//             thinking of that entry or not. This prototype version does
-//             nothing to account for the player making a mistake or possible
-//             dissent among what a question entails
-void TwentyQgame::run_proto()
+// Does:       Reads the two text files in the usual way, then writes their 
+//             contents to a dataset file that a game can be loaded from 
+//             without parsing any text
+void TwentyQgame::convert(string entriesFile, string qsFile, string outFile)
 {
-    KDtree proto(entriesVec, questionsVec, version_num);
-    char command;
-
-    while (proto.size_of_pool() > 1) {
-        cout << proto.question_at_curr() << endl;
-        cin >> command;
-        if (command == 'y' or command == 'n') {
-            proto.advance(command == 'y');
-        }
-    }
+    TwentyQgame game;
+    game.read_entries(entriesFile);
+    game.read_questions(qsFile);
+    datasetFile::write(outFile, game.prompt, game.questionsVec,
+                       game.entriesVec, game.answersMat);
+}
 
-    cout << "Are you thinking of " << proto.entry_at_curr() << "?" << endl;
-    cin >> command;
-    if (command == 'y') {
-        cout << "I win!!!" << endl;
-    } else {
-        cout << "You win, I am stumped..." << endl;
-    }
+// Function compile
+// Parameters: The name of the file to write
+// Returns:    None
+// Does:       Builds the tree for this game's version, then writes it to a
+//             tree file that can later be played with the treeFileName 
+//             constructor, skipping the parsing and the build
+void TwentyQgame::compile(string outFile)
+{
+    // A tree file holds the whole tree, so it is never built lazily
+    BuildOptions compile_options = build_options;
+    compile_options.lazy = false;
+    runStats::Timer building(runStats::BUILD);
+    KDtree compiled(data, version_num, compile_options);
+    compiled.write_file(outFile, prompt, version_num);
 }
 
-// Function run_neighbors
+// Function make_tree
 // Parameters: None
-// Returns:    None
-// Does:       Runs in an identical fashion to run_prob, execept here it tracks
-//             the number of questions that it has asked so it doesn't go over
-//             the maximum of 20. When it reaches a single entry that it could
-//             be, it guesses it and if the user tells the program that that 
-//             was an incorrect guess, it calls the guess_neighbors function
-//             on that guess, in order to guess similar data points to that 
-//             point
-void TwentyQgame::run_neighbors()
+// Returns:    A pointer to this game's KDtree, which is kept in the tree data
+//             member so that it is recycled with the game
+// Does:       Makes the tree the first time that it is asked for, playing on
+//             the mapped tree file if there is one, and building the tree 
+//             from the entries and questions otherwise
+KDtree *TwentyQgame::make_tree()
 {
-    KDtree neigh(entriesVec, questionsVec, version_num);
-    char command;
-    int guesses_made = 0;
-
-    // Stop before question 20 because we want to make a guess and that counts
-    while (neigh.size_of_pool() > 1 and guesses_made < 19) {
-        cout << (guesses_made + 1) << ". " << neigh.question_at_curr() << endl;
-        cin >> command;
-        if (command == 'y' or command == 'n') {
-            neigh.advance(command == 'y');
-            guesses_made++;
-        }
+    if (tree != nullptr) {
+        return tree;
     }
-
-    cout << (guesses_made + 1) << ". Are you thinking of " 
-         << neigh.entry_at_curr() << "?" << endl;
-    cin >> command;
-    guesses_made++;
-    if (command == 'y') {
-        cout << "I win!!!" << endl;
-    } else if (guesses_made < 20) {
-        // if that was our last guess left, there is no need to ask the 
-        // neighbors
-        guess_neighbors(neigh.entry_at_curr(), guesses_made);
+    runStats::Timer building(runStats::BUILD);
+    if (tree_file != nullptr) {
+        tree = new KDtree(*tree_file);
+    } else {
+        tree = new KDtree(data, version_num, build_options);
     }
+    return tree;
 }
 
-// Function guess_neighbors
-// Parameters: A string, the name of an entry that we will attempt to find the
-//             neighbors of and an integer guesses_so_far so that we know how
-//             many of the neighbors we can guess
-// Returns:    None
-// Does:       Uses an instance of the hammingTrie class to find all entries 
-//             that have a hamming distance of 1 from the binary list that is 
-//             the given entry's answers vector. Essentially we give the player
-//             a little slack and allow them to have made one error or dissent
-//             of judgement when answering the questions. If it hasn't guessed
-//             it yet and there is still guesses left to be made, it will begin
-//             to guess entries that are two responses off.
-void TwentyQgame::guess_neighbors(string point, int guesses_so_far)
+// Function neighbor_index
+// Parameters: None
+// Returns:    The hammingTrie of this game's entries
+// Does:       Builds the hammingTrie the first time that it is asked for, 
+//             reading the entries out of the tree file first if the game is 
+//             played from one. Any other thread that asks for it while it is
+//             being built waits for it to be finished
+const hammingTrie &TwentyQgame::neighbor_index()
 {
-    char command;
-    hammingTrie neighborhood(entriesVec);
-    // find_neighbors_of makes a stack in which the highest priority elements 
-    // are the one degree separated data points and the lower priority elements
-    // are the two degree separated data points
-    neighborhood.find_neighbors_of(point);
-    string guess = neighborhood.get_a_neighbor();
-
-    while (guesses_so_far < 20 and guess != "No more neighbors") {
-        cout << (guesses_so_far + 1) << ". Are you thinking of " << guess
-             << "?" << endl;
-        cin >> command;
-        if (command == 'y') {
-            cout << "I win!!!" << endl;
-            return;
+    call_once(neighborhood_once, [this]() {
+        if (data == nullptr) {
+            read_tree_entries();
+            share_dataset(false);
         }
-        guess = neighborhood.get_a_neighbor();
-        guesses_so_far++;
-    }
-    cout << "You win, I am stumped..." << endl;
+        runStats::Timer building(runStats::BUILD);
+        neighborhood = new hammingTrie(data, build_options.radix_neighbors);
+    });
+    return *neighborhood;
 }
 
-// Function run_prob
+// Function run
 // Parameters: None
 // Returns:    None
-// Does:       Gameplay loop of the 2.0 version of the program where instead of
-//             merely yes or no, the user can enter probably, probably not, or
-//             unknown to give the program a better perspective on how 
-//             polarizing that question was. If it reaches a dead end, where it
-//             has narrowed it down to just one entry, and the human player is
-//             telling it "no, thats not what I'm thinking of", the program
-//             can return to the state it was before a question was answered
-//             unknown or probably and try the opposite side of that question
-//             while rettaining the knowledge that it gained about definite yes
-//             and no answers, so that it won't re-ask the same question
-void TwentyQgame::run_prob()
+// Does:       Plays a gameSession of this game's version on standard input 
+//             and output. Reads a single character for each answer, or a 
+//             whole word when the session reads words, and stops early if 
+//             standard input runs out
+void TwentyQgame::run() 
 {
-    KDtree prob(entriesVec, questionsVec, version_num);
-    string command;
-    int guesses_made = 0;
-    while (guesses_made < 20) {
-        cout << (guesses_made + 1) << ". " << prob.question_at_curr() << endl;
-        guesses_made++;
-        cin >> command;
-        prob.advance_probably(string_to_UI(command));
-        // We need a second while loop so when we have a probably that divides
-        // two pools of size 1, there is no question to ask when we return 
-        while (prob.size_of_pool() <= 1 and guesses_made < 20) {
-            cout << (guesses_made + 1) << ". " 
-                 << "Are you thinking of " << prob.entry_at_curr() << "?\n";
-            guesses_made++;
+    // A lazy tree starts expanding its root in the background, so it is made
+    // before the welcome rather than after the player has read it
+    if (build_options.lazy and version_num < 4.0) {
+        make_tree();
+    }
+    // The neighbors are only needed once a guess has failed, so their index
+    // is built while the player answers the questions
+    if (version_num == 3.0) {
+        neighborhood_builder = thread([this]() { neighbor_index(); });
+    }
+
+    runStats::Timer playing(runStats::PLAY);
+    gameSession session(*this);
+    cout << session.start();
+    while (not session.finished()) {
+        string input;
+        if (session.reads_words()) {
+            cin >> input;
+        } else {
+            char command;
             cin >> command;
-            if (command == "y") {
-                cout << "I win!!!" << endl;
-                return;
-            } else if (not prob.return_to_probably()) {
-                // If there is no probably or unknown to return to and we 
-                // didn't guess correctly, then the player wins
-                cout << "You win! I'm stumped." << endl;
-                return;
-            } 
+            input = string(1, command);
+        }
+        if (not cin) {
+            return;
         }
-    } 
-    cout << "You win! I'm stumped." << endl;
+        cout << session.answer(input);
+    }
 }
 
-
-// I want to continue adding on to this project over winter break, so I left 
-// room for two more version ideas: one could be a hybrid between versions 2.0
-// and 3.0, and the other could be a sort of nueral network that changes the 
-// text files as it learns how people answer questions
-
-void TwentyQgame::run_hybrid()
+// Function serve
+// Parameters: The address to serve on, a port number or a socket path
+// Returns:    None
+// Does:       Makes the tree, and the neighbor index if this version guesses
+//             neighbors, then plays a game with every player that connects 
+//             to the address until the server is stopped. Everything is made
+//             before the first player connects, so that no player waits on
+//             it while the others are being served
+void TwentyQgame::serve(string address)
 {
-    // TODO
+    if (version_num < 4.0) {
+        make_tree();
+    }
+    if (version_num == 3.0) {
+        neighbor_index();
+    }
+    gameServer server(*this);
+    server.listen(address);
+    runStats::Timer playing(runStats::PLAY);
+    server.run();
 }
-    
-void TwentyQgame::run_neural()
+
+// Function simulate
+// Parameters: The share of the answers to questions that are made noisy
+// Returns:    None
+// Does:       Times making the tree, and the neighbor index if this version
+//             guesses neighbors, then plays a game for every entry with no
+//             one at the keyboard and prints how well and how fast they were
+//             played. A tree file's entries are read from it, since the 
+//             player answers from them. Exits if this version has no game
+void TwentyQgame::simulate(double noise)
 {
-    // TODO
+    if (version_num >= 4.0) {
+        cerr << "Version " << version_num << " has no game to simulate"
+             << endl;
+        exit(1);
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    make_tree();
+    if (version_num == 3.0) {
+        neighbor_index();
+    }
+    double build_seconds = chrono::duration<double>(
+                           chrono::steady_clock::now() - start).count();
+    if (data == nullptr) {
+        read_tree_entries();
+        share_dataset(false);
+    }
+
+    selfPlay player(*this, noise, build_options.seed);
+    {
+        runStats::Timer playing(runStats::PLAY);
+        player.play_all();
+    }
+    player.report(build_seconds);
 }
 
 // function read_entries
@@ -263,12 +298,27 @@ void TwentyQgame::run_neural()
 //             directory, this is the text file from which we will read the 
 //             entries and their answers to each question. 
 // Returns:    None
+// Does:       Parses the file with the chunked parser, on as many threads as
+//             the BuildOptions ask for, when it is a regular file that can be
+//             mapped, and reads it as a stream otherwise
+void TwentyQgame::read_entries(string entriesFile)
+{
+    if (not parse_entries_file(entriesFile, build_options.threads, 
+                               entriesVec, answersMat)) {
+        read_entries_stream(entriesFile);
+    }
+}
+
+// function read_entries_stream
+// Parameters: A string, the name of the entries file
+// Returns:    None
 // Does:       Opens the file (exiting if the file does not exist), reads one
 //             pair of lines at a time, the first is stored as the name of the
 //             entry (a string), the second line is read in one integer at a 
-//             time. These will be stored as the answers in the answers vector
-//             of the entry.
-void TwentyQgame::read_entries(string entriesFile)
+//             time. These will be stored as the entry's row of bits in the 
+//             answersMat. The first row decides how many answers every entry
+//             has, and a row of a different length is an error
+void TwentyQgame::read_entries_stream(string entriesFile)
 {
     ifstream entries_in;
     entries_in.open(entriesFile);
@@ -279,22 +329,71 @@ void TwentyQgame::read_entries(string entriesFile)
 
     int answer;
     string name, answers;
+    vector<int> row;
     while (getline(entries_in, name)) {
         Entry new_entry;
         new_entry.name = name;
         // Make a string stream from the second line so that we can parse it 
-        // for one integer at a time and store them individually in a vector
+        // for one integer at a time and store them in the reusable row
         getline(entries_in, answers);
         stringstream s(answers);
+        row.clear();
         while (s >> answer) {
-            new_entry.answers.push_back(answer);
+            row.push_back(answer);
+        }
+
+        if (entriesVec.empty()) {
+            answersMat.set_num_questions(row.size());
+        } else if (row.size() != answersMat.num_questions()) {
+            cerr << "Entry " << name << " has " << row.size() 
+                 << " answers, expected " << answersMat.num_questions() 
+                 << endl;
+            exit(1);
         }
+        answersMat.add_row(row);
         entriesVec.push_back(new_entry);
     }
 
     entries_in.close();
 }
 
+// function read_tree_entries
+// Parameters: None
+// Returns:    None
+// Does:       Copies the entry names out of the mapped tree file into
+//             entriesVec, and has answersMat borrow the packed answers where
+//             they are mapped, for the parts of the game that work on the
+//             entries rather than on the tree. Only done when one of those
+//             parts is reached, so that a game played from a tree file starts
+//             without touching them
+void TwentyQgame::read_tree_entries()
+{
+    runStats::Timer loading(runStats::LOAD);
+    answersMat.set_num_questions(tree_file->num_answers());
+    answersMat.borrow_rows(tree_file->num_entries(),
+                           tree_file->answer_rows());
+    for (size_t i = 0; i < tree_file->num_entries(); i++) {
+        Entry new_entry;
+        new_entry.name = tree_file->entry_name(i);
+        entriesVec.push_back(new_entry);
+    }
+}
+
+// function share_dataset
+// Parameters: Whether the answers are needed as columns, which only the 
+//             building of a KDtree needs
+// Returns:    None
+// Does:       Moves everything that has been read into a new dataset, which
+//             every part of the game shares from then on, leaving the vectors
+//             that it was read into empty
+void TwentyQgame::share_dataset(bool with_columns)
+{
+    data = shared_ptr<const dataset>(new dataset(move(entriesVec), 
+                                                 move(questionsVec), 
+                                                 move(answersMat),
+                                                 with_columns));
+}
+
 // function read_questions
 // Parameters: A string, questionsFile, which is the name of the text file that
 //             we will open and read from
@@ -303,8 +402,7 @@ void TwentyQgame::read_entries(string entriesFile)
 //             error message and crashing if the given file could not be 
 //             opened. Then uses getline to read each line in the text file in 
 //             storing that line as the string element of a Question in the 
-//             questions vector. Initializes the truth element of each 
-//             Question that it adds to the vector as "Unknown"
+//             questions vector.
 void TwentyQgame::read_questions(string questionsFile)
 {
     ifstream questions_in;
@@ -319,13 +417,38 @@ void TwentyQgame::read_questions(string questionsFile)
     while (getline(questions_in, questionStr)) {
         Question new_question;
         new_question.question = questionStr;
-        new_question.truth = unknown;
         questionsVec.push_back(new_question);
     }
 
     questions_in.close();
 }
 
+// function read_dataset
+// Parameters: A string, the name of a dataset file written by convert
+// Returns:    None
+// Does:       Maps the file, exiting if it cannot be used, then copies the
+//             prompt, questions and entry names out of its string table and
+//             hands its columns to the answersMat, which rebuilds the rows
+//             from them
+void TwentyQgame::read_dataset(string datasetFileName)
+{
+    datasetFile dataset;
+    dataset.map(datasetFileName);
+
+    prompt = dataset.prompt();
+    questionsVec.resize(dataset.num_questions());
+    for (size_t i = 0; i < questionsVec.size(); i++) {
+        questionsVec[i].question = dataset.question(i);
+    }
+    entriesVec.resize(dataset.num_entries());
+    for (size_t i = 0; i < entriesVec.size(); i++) {
+        entriesVec[i].name = dataset.entry_name(i);
+    }
+
+    answersMat.set_num_questions(dataset.num_answers());
+    answersMat.set_columns(dataset.num_entries(), dataset.columns());
+}
+
 // Function set_version_num
 // Parameters: a string, version, this was one of the three additional command
 //             line arguments that were given with the executable
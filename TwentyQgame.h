@@ -12,13 +12,24 @@
 //
 //
 #include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
 #include "KDtree.h"
 #include "questions_and_entries.h"
+#include "answerMatrix.h"
+#include "dataset.h"
 #include "userInput.h"
 #include "hammingTrie.h"
+#include "options.h"
+#include "treeFile.h"
+#include "datasetFile.h"
 
 using namespace std;
 
+#ifndef _20Q_GAME_H_
+#define _20Q_GAME_H_
+
 const string ACKNOWLEDGEMENTS = "This project is the independent project "
                                 "designed and written by Miles Izydorczak"
                                 "for his data structures class at Tufts "
@@ -28,39 +39,66 @@ const string ACKNOWLEDGEMENTS = "This project is the independent project "
                                 "Mark Sheldon and Matias Korman and the rest "
                                 "of the Tufts computer \nscience department.";
 
-#ifndef _20Q_GAME_H_
-#define _20Q_GAME_H_
-
 class TwentyQgame {
 public:
 
 	TwentyQgame(string version, string entriesFile, string qsFile);
+    TwentyQgame(string version, string entriesFile, string qsFile,
+                BuildOptions &options);
+    TwentyQgame(string version, string datasetFileName, 
+                BuildOptions &options);
+    TwentyQgame(string treeFileName, BuildOptions &options);
+    ~TwentyQgame();
 
     void run();
+    void serve(string address);
+    void simulate(double noise);
+    void compile(string outFile);
+
+    static void convert(string entriesFile, string qsFile, string outFile);
 
 private:
+    friend class gameSession;
+    friend class selfPlay;
+
+    TwentyQgame();
 
+    // The questions, entries and answers are read into these, then moved
+    // into the dataset that the game's KDtree and hammingTrie share
     vector<Question> questionsVec;
     vector<Entry> entriesVec;
+    answerMatrix answersMat;
+    shared_ptr<const dataset> data;
 
     double version_num;
     string prompt;
 
-    void read_entries(string entriesFile);
-    void read_questions(string questionsFile);
-    void set_version_num(string version);
+    BuildOptions build_options;
+
+    // The mapped tree file that the game is played from, or nullptr when the
+    // tree is built from the text files, and the tree of the current game
+    treeFile *tree_file;
+    KDtree *tree;
 
-    void run_welcome();
+    // The index of the entries' neighbors, built once, on a thread of its 
+    // own as soon as a game that guesses neighbors starts, and shared by 
+    // every search for neighbors after that
+    hammingTrie *neighborhood;
+    once_flag neighborhood_once;
+    thread neighborhood_builder;
 
-    void run_proto();
-    void run_prob();
-    void run_neighbors();
-    void run_hybrid();
-    void run_neural();
+    KDtree *make_tree();
+    const hammingTrie &neighbor_index();
+    void read_tree_entries();
+    void share_dataset(bool with_columns);
 
-    void guess_neighbors(string point, int guesses_so_far);
+    void read_entries(string entriesFile);
+    void read_entries_stream(string entriesFile);
+    void read_questions(string questionsFile);
+    void read_dataset(string datasetFileName);
+    void set_version_num(string version);
 
-    userInput string_to_UI(string s);
+    static userInput string_to_UI(string s);
 
 };
 
@@ -0,0 +1,212 @@
+// answerMatrix.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the answerMatrix class
+//
+
+#include <vector>
+#include "answerMatrix.h"
+#include "splitKernels.h"
+
+using namespace std;
+
+// Constructor answerMatrix
+// Does: Initializes an empty matrix with no entries and no questions
+answerMatrix::answerMatrix()
+{
+    n_entries = 0;
+    n_questions = 0;
+    row_words = 0;
+    column_words = 0;
+    row_data = rows.data();
+}
+
+// Function set_num_questions
+// Parameters: A size_t, the number of answers that every row will hold
+// Returns:    None
+// Does:       Sets the width of the matrix. Must be called before any rows
+//             are added, because the width decides how many words each row
+//             takes up
+void answerMatrix::set_num_questions(size_t num_questions)
+{
+    n_questions = num_questions;
+    row_words = (num_questions + 63) / 64;
+}
+
+// Function add_row
+// Parameters: A vector of integers, the 0/1 answers of one entry, passed by
+//             reference
+// Returns:    None
+// Does:       Appends a row of zeroed words to the end of the matrix, then
+//             sets the bit of every question that the entry answered with a
+//             non-zero value. Answers beyond the width of the matrix are
+//             ignored
+void answerMatrix::add_row(vector<int> &answers)
+{
+    size_t start = rows.size();
+    rows.resize(start + row_words, 0);
+
+    for (size_t i = 0; i < answers.size() and i < n_questions; i++) {
+        if (answers[i] != 0) {
+            rows[start + (i >> 6)] |= static_cast<uint64_t>(1) << (i & 63);
+        }
+    }
+    n_entries++;
+    columns.clear();
+    row_data = rows.data();
+}
+
+// Function add_packed_row
+// Parameters: A pointer to words_per_row() words that hold one entry's
+//             answers, packed in the same way as the rows of this matrix
+// Returns:    None
+// Does:       Appends a copy of the row to the end of the matrix
+void answerMatrix::add_packed_row(const uint64_t *packed)
+{
+    rows.insert(rows.end(), packed, packed + row_words);
+    n_entries++;
+    columns.clear();
+    row_data = rows.data();
+}
+
+// Function add_rows
+// Parameters: The number of rows to add
+// Returns:    None
+// Does:       Appends that many rows of all no answers to the end of the 
+//             matrix, to be filled in through mutable_row
+void answerMatrix::add_rows(size_t count)
+{
+    rows.resize(rows.size() + count * row_words, 0);
+    n_entries += count;
+    columns.clear();
+    row_data = rows.data();
+}
+
+// Function set_columns
+// Parameters: The number of entries, and a pointer to the question-major 
+//             columns of their answers, laid out as column() describes
+// Returns:    None
+// Does:       Replaces every row of the matrix. Copies the columns as they
+//             are, then transposes them into the rows by walking the set bits
+//             of each column, the reverse of build_columns. Bits past the 
+//             last entry are ignored. The width of the matrix must already 
+//             have been set
+void answerMatrix::set_columns(size_t num_entries, const uint64_t *packed)
+{
+    n_entries = num_entries;
+    column_words = (n_entries + 63) / 64;
+    columns.assign(packed, packed + n_questions * column_words);
+    rows.assign(n_entries * row_words, 0);
+    row_data = rows.data();
+
+    for (size_t q = 0; q < n_questions; q++) {
+        const uint64_t *c = column(q);
+        uint64_t question_bit = static_cast<uint64_t>(1) << (q & 63);
+        size_t question_word = q >> 6;
+        for (size_t w = 0; w < column_words; w++) {
+            uint64_t bits = c[w];
+            while (bits != 0) {
+                size_t e = w * 64 + __builtin_ctzll(bits);
+                if (e >= n_entries) {
+                    break;
+                }
+                rows[e * row_words + question_word] |= question_bit;
+                bits &= bits - 1;
+            }
+        }
+    }
+}
+
+// Function clear
+// Parameters: None
+// Returns:    None
+// Does:       Removes every row, keeping the width of the matrix
+void answerMatrix::clear()
+{
+    rows.clear();
+    columns.clear();
+    n_entries = 0;
+    column_words = 0;
+    row_data = rows.data();
+}
+
+// Function borrow_rows
+// Parameters: The number of entries, and a pointer to their rows, laid out
+//             as row() describes
+// Returns:    None
+// Does:       Replaces every row of the matrix with the rows at the pointer,
+//             which are read where they are rather than copied. The width of
+//             the matrix must already have been set
+void answerMatrix::borrow_rows(size_t num_entries, const uint64_t *packed)
+{
+    rows.clear();
+    columns.clear();
+    n_entries = num_entries;
+    column_words = 0;
+    row_data = packed;
+}
+
+// Function build_columns
+// Parameters: None
+// Returns:    None
+// Does:       Transposes the rows into the question-major columns, one bitset
+//             over all of the entries per question. Walks the set bits of 
+//             each row so that the cost is proportional to the number of yes
+//             answers rather than to entries times questions
+void answerMatrix::build_columns()
+{
+    column_words = (n_entries + 63) / 64;
+    columns.assign(n_questions * column_words, 0);
+
+    for (size_t e = 0; e < n_entries; e++) {
+        const uint64_t *r = row(e);
+        uint64_t entry_bit = static_cast<uint64_t>(1) << (e & 63);
+        size_t entry_word = e >> 6;
+        for (size_t w = 0; w < row_words; w++) {
+            uint64_t bits = r[w];
+            while (bits != 0) {
+                size_t q = w * 64 + __builtin_ctzll(bits);
+                columns[q * column_words + entry_word] |= entry_bit;
+                bits &= bits - 1;
+            }
+        }
+    }
+}
+
+// Function has_columns
+// Parameters: None
+// Returns:    A bool, true if the columns are up to date with the rows
+bool answerMatrix::has_columns() const
+{
+    return column_words == (n_entries + 63) / 64 and 
+           columns.size() == n_questions * column_words;
+}
+
+// Function count_yes
+// Parameters: A bitset over the entries of the matrix, marking the entries 
+//             that are in a pool, the range of its words [first_word, 
+//             last_word) that may hold set bits, the number of questions to
+//             count, and a vector of integers to write the counts into
+// Returns:    None
+// Does:       For every question, counts the entries in the pool that answer
+//             yes by streaming through the question's column and the pool's
+//             bitset, adding the popcount of their AND. The counting itself
+//             is done by whichever split kernel suits this processor
+void answerMatrix::count_yes(const uint64_t *pool_bits, size_t first_word,
+                             size_t last_word, size_t num_qs,
+                             vector<int> &counts) const
+{
+    counts.resize(num_qs);
+    count_yes_columns(columns.data(), column_words, pool_bits, first_word,
+                      last_word, num_qs, counts.data());
+}
+
+// Function memory_bytes
+// Parameters: None
+// Returns:    A size_t, the number of bytes used to hold the answers
+// Does:       Multiplies the number of words in the matrix by their size.
+//             Borrowed rows are not counted
+size_t answerMatrix::memory_bytes() const
+{
+    return (rows.size() + columns.size()) * sizeof(uint64_t);
+}
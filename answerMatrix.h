@@ -0,0 +1,110 @@
+// answerMatrix.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the answerMatrix class. Stores the yes/no answers of
+//          every entry to every question as bits, 64 answers to a word, with
+//          the rows of all of the entries laid out back to back in a single
+//          contiguous vector. This replaces a vector of integers per entry,
+//          which cost four bytes per answer plus a heap allocation per entry
+//          The matrix can also build a question-major copy of itself, where
+//          every question is a bitset over the entries, so that the number of
+//          entries in a pool that answer yes is a popcount of an AND.
+//          Rather than holding rows of its own, a matrix can borrow rows that
+//          are already in memory, such as those of a mapped tree file, which
+//          must then outlive it
+//
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+using namespace std;
+
+#ifndef _ANSWERMATRIX_H_
+#define _ANSWERMATRIX_H_
+
+class answerMatrix {
+public:
+    answerMatrix();
+    // A copy would point at the rows of the matrix that it was copied from,
+    // so matrices are only ever moved
+    answerMatrix(const answerMatrix &) = delete;
+    answerMatrix &operator=(const answerMatrix &) = delete;
+    answerMatrix(answerMatrix &&) = default;
+    answerMatrix &operator=(answerMatrix &&) = default;
+
+    void set_num_questions(size_t num_questions);
+    void add_row(vector<int> &answers);
+    void add_packed_row(const uint64_t *packed);
+    void set_columns(size_t num_entries, const uint64_t *packed);
+    void borrow_rows(size_t num_entries, const uint64_t *packed);
+    void add_rows(size_t count);
+    void clear();
+    void build_columns();
+    bool has_columns() const;
+
+    void count_yes(const uint64_t *pool_bits, size_t first_word, 
+                   size_t last_word, size_t num_qs, 
+                   vector<int> &counts) const;
+
+    // Function get
+    // Parameters: The index of an entry and the index of a question
+    // Returns:    A bool, true if the entry's answer to the question is yes
+    // Does:       Reads the single bit that holds this answer
+    bool get(size_t entry, size_t question) const
+    {
+        return (row_data[entry * row_words + (question >> 6)]
+                >> (question & 63)) & 1;
+    }
+
+    // Function row
+    // Parameters: The index of an entry
+    // Returns:    A pointer to the first of words_per_row() words that hold
+    //             the entry's answers, question q being bit (q % 64) of
+    //             word (q / 64)
+    const uint64_t *row(size_t entry) const
+    {
+        return row_data + entry * row_words;
+    }
+
+    // Function mutable_row
+    // Parameters: The index of an entry
+    // Returns:    The same pointer as row, through which the entry's answers
+    //             can be set. Writers of different rows may run in parallel.
+    //             Not valid on a matrix that borrows its rows
+    uint64_t *mutable_row(size_t entry)
+    {
+        return rows.data() + entry * row_words;
+    }
+
+    // Function column
+    // Parameters: The index of a question
+    // Returns:    A pointer to the first of words_per_column() words, where 
+    //             entry e is bit (e % 64) of word (e / 64). Only valid after
+    //             build_columns has been called
+    const uint64_t *column(size_t question) const
+    {
+        return columns.data() + question * column_words;
+    }
+
+    size_t num_entries() const { return n_entries; }
+    size_t num_questions() const { return n_questions; }
+    size_t words_per_row() const { return row_words; }
+    size_t words_per_column() const { return column_words; }
+
+    size_t memory_bytes() const;
+
+private:
+    size_t n_entries;
+    size_t n_questions;
+    size_t row_words;
+    size_t column_words;
+
+    vector<uint64_t> rows;
+    // The first word of the rows, in rows or in the memory that they are
+    // borrowed from
+    const uint64_t *row_data;
+    vector<uint64_t> columns;
+};
+
+#endif
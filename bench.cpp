@@ -0,0 +1,315 @@
+// bench.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Microbenchmarks of the kernels that the game's speed rests on:
+//          choosing a question, building each kind of tree, searching for
+//          neighbors, the stacks of a game and reading an entries file. Each
+//          is run on made up catalogs of several sizes, from the
+//          catalogGenerator, and timed over enough runs to last a minimum
+//          time. Every allocation is counted by replacing the global
+//          operator new. The results are printed to standard output as JSON,
+//          one record per kernel and size, so that the results of two
+//          commits can be compared, and the progress to standard error.
+//          Usage: ./20Qbench [--questions Q] [--min-time seconds] [sizes...]
+//
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <new>
+#include <unistd.h>
+#include "KDtree.h"
+#include "hammingTrie.h"
+#include "dataset.h"
+#include "catalogGenerator.h"
+#include "entriesParser.h"
+#include "options.h"
+#include "Stack.h"
+#include "splitKernels.h"
+
+using namespace std;
+
+// Every call of the global operator new, on any thread
+static atomic<size_t> allocations(0);
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+// The depth of the stacks of probablies of a game that has answered about
+// half of its twenty questions unsure
+static const int STACK_DEPTH = 10;
+
+const string USAGE = "Usage: ./20Qbench [--questions Q] [--min-time seconds] "
+                     "[numEntries ...]";
+
+// The private kernels of the KDtree, which is a friend of this class
+class treeBench {
+public:
+    static int best_question(KDtree &tree)
+    {
+        return tree.select_best_question(tree.order.data(),
+                                         tree.order.size());
+    }
+
+    static void count_yes(KDtree &tree, vector<int> &counts)
+    {
+        tree.count_pool_yes(tree.order.data(), tree.order.size(), counts);
+    }
+
+    static int best_sum(KDtree &tree, const vector<int> &counts)
+    {
+        return tree.select_best_sum(counts, tree.order.size());
+    }
+
+    static int sample_question(KDtree &tree)
+    {
+        return tree.select_sample_question(0, tree.order.size());
+    }
+};
+
+struct Result {
+    string name;
+    size_t entries;
+    size_t questions;
+    long iterations;
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+// Function measure
+// Parameters: The name of the kernel, the size of the catalog that it runs
+//             on, the minimum time to run it for, the function that runs it
+//             once, and the results, passed by reference
+// Returns:    None
+// Does:       Runs the kernel once to warm up, then runs it a doubling number
+//             of times until the runs last the minimum time, and adds the
+//             time and the allocations per run of the last round
+void measure(string name, size_t entries, size_t questions, double min_time,
+             function<void()> op, vector<Result> &results)
+{
+    op();
+    long iterations = 1;
+    while (true) {
+        size_t allocs_before = allocations.load();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (long i = 0; i < iterations; i++) {
+            op();
+        }
+        double seconds = chrono::duration<double>(
+                         chrono::steady_clock::now() - start).count();
+        size_t allocs = allocations.load() - allocs_before;
+        if (seconds >= min_time or iterations >= (1L << 30)) {
+            Result result;
+            result.name = name;
+            result.entries = entries;
+            result.questions = questions;
+            result.iterations = iterations;
+            result.ns_per_op = seconds * 1e9 / iterations;
+            result.allocs_per_op = static_cast<double>(allocs) / iterations;
+            results.push_back(result);
+            cerr << name << " " << entries << ": " << result.ns_per_op
+                 << " ns/op, " << result.allocs_per_op << " allocs/op"
+                 << endl;
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+// Function bench_size
+// Parameters: The number of entries and questions of the catalog, the
+//             minimum time of each kernel, and the results, passed by
+//             reference
+// Returns:    None
+// Does:       Makes a catalog of that size, with a little of everything that
+//             the generator can do, and runs every kernel on it
+void bench_size(size_t num_entries, size_t num_questions, double min_time,
+                vector<Result> &results)
+{
+    GeneratorOptions generator;
+    generator.num_entries = num_entries;
+    generator.num_questions = num_questions;
+    generator.yes_spread = 0.3;
+    generator.clusters = num_questions / 8;
+    generator.duplicates = 0.01;
+    catalogGenerator catalog(generator);
+
+    vector<Entry> entries;
+    vector<Question> questions;
+    answerMatrix answers;
+    catalog.make(entries, questions, answers);
+    shared_ptr<const dataset> data(new dataset(move(entries),
+                                               move(questions),
+                                               move(answers), true));
+    size_t n = num_entries, q = num_questions;
+
+    // Version 0.0 is the cheapest tree to build, and all that the question
+    // kernels need of it is its data and its order
+    KDtree tree(data, 0.0);
+    vector<int> counts;
+    treeBench::count_yes(tree, counts);
+    measure("select_best_question", n, q, min_time, [&]() {
+                treeBench::best_question(tree); }, results);
+    measure("select_best_sum", n, q, min_time, [&]() {
+                treeBench::best_sum(tree, counts); }, results);
+    measure("select_sample_question", n, q, min_time, [&]() {
+                treeBench::sample_question(tree); }, results);
+
+    const char *builds[] = { "build_tree_order", "build_tree_best",
+                             "build_tree_sample", "build_tree_sums" };
+    const double versions[] = { 0.0, 1.0, 1.1, 1.5 };
+    for (int i = 0; i < 4; i++) {
+        double version = versions[i];
+        measure(builds[i], n, q, min_time, [&]() {
+                    KDtree built(data, version); }, results);
+    }
+
+    const char *tries[] = { "find_neighbors_of_hash",
+                            "find_neighbors_of_radix" };
+    for (int i = 0; i < 2; i++) {
+        hammingTrie trie(data, i == 1);
+        size_t next = 0;
+        measure(tries[i], n, q, min_time, [&]() {
+                    trie.find_neighbors_of(static_cast<int>(next), 2);
+                    next = (next + 7919) % n; }, results);
+    }
+
+    string dir = getenv("TMPDIR") != nullptr ? getenv("TMPDIR") : "/tmp";
+    string entries_file = dir + "/20Qbench_es_" + to_string(getpid()) +
+                          ".txt";
+    string questions_file = dir + "/20Qbench_qs_" + to_string(getpid()) +
+                            ".txt";
+    catalog.write_text(entries_file, questions_file);
+    measure("read_entries", n, q, min_time, [&]() {
+                vector<Entry> read;
+                answerMatrix read_answers;
+                parse_entries_file(entries_file, 1, read, read_answers); },
+            results);
+    remove(entries_file.c_str());
+    remove(questions_file.c_str());
+}
+
+// Function bench_stacks
+// Parameters: The minimum time of each kernel, and the results, passed by
+//             reference
+// Returns:    None
+// Does:       Times a push and a pop on the linked Stack that games once kept
+//             their probablies in, and on the vector that they keep them in
+//             now, each holding as many as a game usually does
+void bench_stacks(double min_time, vector<Result> &results)
+{
+    Stack<uint32_t> stack;
+    vector<uint32_t> frontier;
+    for (int i = 0; i < STACK_DEPTH; i++) {
+        stack.push(i);
+        frontier.push_back(i);
+    }
+    measure("stack_push_pop", STACK_DEPTH, 0, min_time, [&]() {
+                stack.push(stack.top() + 1);
+                stack.pop(); }, results);
+    measure("vector_push_pop", STACK_DEPTH, 0, min_time, [&]() {
+                frontier.push_back(frontier.back() + 1);
+                frontier.pop_back(); }, results);
+}
+
+// Function print_json
+// Parameters: The results, passed by reference
+// Returns:    None
+// Does:       Prints the results as a JSON object with a list of records,
+//             along with the split kernels that they were measured with
+void print_json(vector<Result> &results)
+{
+    cout << "{\"split_kernel\": \"" << split_kernel_name() << "\","
+         << endl << " \"benchmarks\": [" << endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        Result &r = results[i];
+        cout << "  {\"name\": \"" << r.name << "\", \"entries\": "
+             << r.entries << ", \"questions\": " << r.questions
+             << ", \"iterations\": " << r.iterations << ", \"ns_per_op\": "
+             << r.ns_per_op << ", \"allocs_per_op\": " << r.allocs_per_op
+             << "}" << (i + 1 < results.size() ? "," : "") << endl;
+    }
+    cout << "]}" << endl;
+}
+
+// Function read_count
+// Parameters: The name of an argument and the string that was given for it
+// Returns:    The value as an integer
+// Does:       Converts the value, printing the usage and exiting if it is not
+//             a positive integer
+long read_count(string name, string value)
+{
+    char *end;
+    long count = strtol(value.c_str(), &end, 10);
+    if (value.empty() or *end != '\0' or count < 1) {
+        cerr << "Invalid value for " << name << ": " << value << endl
+             << USAGE << endl;
+        exit(1);
+    }
+    return count;
+}
+
+// Function read_seconds
+// Parameters: The name of an argument and the string that was given for it
+// Returns:    The value as a double
+// Does:       Converts the value, printing the usage and exiting if it is not
+//             a positive number
+double read_seconds(string name, string value)
+{
+    char *end;
+    double seconds = strtod(value.c_str(), &end);
+    if (value.empty() or *end != '\0' or not (seconds > 0)) {
+        cerr << "Invalid value for " << name << ": " << value << endl
+             << USAGE << endl;
+        exit(1);
+    }
+    return seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t num_questions = 64;
+    double min_time = 0.2;
+    vector<size_t> sizes;
+    for (int arg = 1; arg < argc; arg++) {
+        string option = argv[arg];
+        if (option == "--questions" and arg + 1 < argc) {
+            num_questions = read_count(option, argv[++arg]);
+        } else if (option == "--min-time" and arg + 1 < argc) {
+            min_time = read_seconds(option, argv[++arg]);
+        } else {
+            sizes.push_back(read_count("numEntries", option));
+        }
+    }
+    if (sizes.empty()) {
+        sizes.push_back(1000);
+        sizes.push_back(10000);
+        sizes.push_back(100000);
+    }
+
+    vector<Result> results;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        bench_size(sizes[i], num_questions, min_time, results);
+    }
+    bench_stacks(min_time, results);
+    print_json(results);
+    return 0;
+}
@@ -0,0 +1,299 @@
+// catalogGenerator.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the catalogGenerator class
+//
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include "catalogGenerator.h"
+#include "datasetFile.h"
+
+using namespace std;
+
+// Each batch of rows is made to be about this many bytes of text
+static const size_t BATCH_BYTES = 1 << 20;
+static const int BATCHES_PER_THREAD = 4;
+
+// Spreads the entries' random streams far apart from one another, and from
+// the stream that the questions' chances are drawn from
+static const uint64_t ENTRY_STREAM = 0xD1B54A32D192ED03ULL;
+static const uint64_t QUESTION_STREAM = 0x5175657374696F6EULL;
+
+// Constructor catalogGenerator
+// Parameters: The settings of the catalog, passed by reference
+// Does:       Draws every question's chance of a yes from the seed, and
+//             starts a pool of threads if more than one is asked for. There
+//             are never more clusters than questions
+catalogGenerator::catalogGenerator(GeneratorOptions &options)
+    : options(options)
+{
+    if (this->options.clusters > this->options.num_questions) {
+        this->options.clusters = this->options.num_questions;
+    }
+    uint64_t state = options.seed ^ QUESTION_STREAM;
+    for (size_t i = 0; i < options.num_questions; i++) {
+        double draw = static_cast<double>(next_random(state) >> 11) /
+                      (1ULL << 53);
+        thresholds.push_back(threshold_of(options.yes_rate +
+                                          options.yes_spread *
+                                          (2 * draw - 1)));
+    }
+    correlation_threshold = threshold_of(options.correlation);
+    duplicate_threshold = threshold_of(options.duplicates);
+
+    workers = nullptr;
+    if (options.threads > 1) {
+        workers = new taskPool(options.threads);
+    }
+}
+
+// Destructor ~catalogGenerator
+// Does: Stops the pool of threads, if there is one
+catalogGenerator::~catalogGenerator()
+{
+    delete workers;
+}
+
+// Function write_text
+// Parameters: The names of the entries file and the questions file to write
+// Returns:    None
+// Does:       Writes the prompt and the questions, then the entries in the
+//             same format that the game reads: each name on a line of its
+//             own, followed by a line of its answers, 1 or 0, separated by
+//             spaces. The rows are turned into text in rounds of batches,
+//             which are made in parallel and written in order. Exits if a
+//             file cannot be written
+void catalogGenerator::write_text(string entriesFile, string questionsFile)
+{
+    ofstream questions_out(questionsFile);
+    if (not questions_out.is_open()) {
+        cerr << "Error opening questionsFile: " << questionsFile << endl;
+        exit(1);
+    }
+    questions_out << prompt() << "\n";
+    for (size_t i = 0; i < options.num_questions; i++) {
+        questions_out << question_text(i) << "\n";
+    }
+    questions_out.close();
+
+    ofstream entries_out(entriesFile, ios::binary);
+    if (not entries_out.is_open()) {
+        cerr << "Error opening entriesFile: " << entriesFile << endl;
+        exit(1);
+    }
+    size_t num_qs = options.num_questions;
+    size_t words = (num_qs + 63) / 64;
+    size_t batch_size = BATCH_BYTES / (2 * num_qs + 16) + 1;
+    size_t round_size = batch_size * BATCHES_PER_THREAD * options.threads;
+    vector<string> batches;
+
+    for (size_t first = 0; first < options.num_entries; first += round_size) {
+        size_t last = first + round_size;
+        if (last > options.num_entries) {
+            last = options.num_entries;
+        }
+        batches.assign((last - first + batch_size - 1) / batch_size, "");
+        run_batches(first, last, batch_size, [&](size_t begin, size_t end) {
+            string &text = batches[(begin - first) / batch_size];
+            text.reserve((end - begin) * (2 * num_qs + 16));
+            vector<uint64_t> row(words);
+            for (size_t e = begin; e < end; e++) {
+                text += entry_name(e);
+                text += '\n';
+                make_row(e, row.data());
+                for (size_t q = 0; q < num_qs; q++) {
+                    text += (row[q >> 6] >> (q & 63)) & 1 ? '1' : '0';
+                    text += q + 1 < num_qs ? ' ' : '\n';
+                }
+            }
+        });
+        for (size_t i = 0; i < batches.size(); i++) {
+            entries_out.write(batches[i].data(), batches[i].size());
+        }
+    }
+    entries_out.close();
+    if (not entries_out) {
+        cerr << "Error writing entriesFile: " << entriesFile << endl;
+        exit(1);
+    }
+}
+
+// Function write_dataset
+// Parameters: The name of the dataset file to write
+// Returns:    None
+// Does:       Makes the whole catalog in memory and writes it out as a 
+//             dataset file. Unlike the text files, the whole catalog is held
+//             in memory, twice over once its columns are built
+void catalogGenerator::write_dataset(string datasetFileName)
+{
+    vector<Entry> entries;
+    vector<Question> questions;
+    answerMatrix answers;
+    make(entries, questions, answers);
+    datasetFile::write(datasetFileName, prompt(), questions, entries,
+                       answers);
+}
+
+// Function make
+// Parameters: The entries, questions and answers to fill, passed by 
+//             reference
+// Returns:    None
+// Does:       Replaces their contents with the catalog. Every row of answers
+//             is made straight into the answerMatrix, in parallel
+void catalogGenerator::make(vector<Entry> &entries, 
+                            vector<Question> &questions,
+                            answerMatrix &answers)
+{
+    answers.clear();
+    answers.set_num_questions(options.num_questions);
+    answers.add_rows(options.num_entries);
+    size_t batch_size = BATCH_BYTES / (answers.words_per_row() * 8) + 1;
+    run_batches(0, options.num_entries, batch_size,
+                [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; e++) {
+            make_row(e, answers.mutable_row(e));
+        }
+    });
+
+    questions.assign(options.num_questions, Question());
+    for (size_t i = 0; i < options.num_questions; i++) {
+        questions[i].question = question_text(i);
+    }
+    entries.assign(options.num_entries, Entry());
+    for (size_t i = 0; i < options.num_entries; i++) {
+        entries[i].name = entry_name(i);
+    }
+}
+
+// Function prompt
+// Parameters: None
+// Returns:    The prompt of the catalog, the first line of its questions file
+string catalogGenerator::prompt()
+{
+    return "synthetic entry";
+}
+
+// Function question_text
+// Parameters: The index of a question
+// Returns:    The text of the question, which names its cluster if it has one
+string catalogGenerator::question_text(size_t q_index)
+{
+    string text = "Does it have trait " + to_string(q_index);
+    if (options.clusters > 0) {
+        text += " of cluster " +
+                to_string(q_index * options.clusters / options.num_questions);
+    }
+    return text + "?";
+}
+
+// Function entry_name
+// Parameters: The index of an entry
+// Returns:    The name of the entry, which is different for every entry, even
+//             for those that copy the answers of another
+string catalogGenerator::entry_name(size_t entry)
+{
+    return "Entry " + to_string(entry);
+}
+
+// Function make_row
+// Parameters: The index of an entry, and a pointer to the words of its row,
+//             where the answers are written as packed bits
+// Returns:    None
+// Does:       Starts the random stream of the entry. Every entry but the
+//             first may copy an earlier entry, in which case that entry's row
+//             is made instead, and so on, until an entry that is not a copy
+//             is reached. Then each question is answered yes if a number
+//             drawn for it is below its threshold. In a cluster, the number
+//             is the one that was drawn for the whole cluster, with a chance
+//             of correlation, and a fresh one otherwise
+void catalogGenerator::make_row(size_t entry, uint64_t *row)
+{
+    uint64_t state = options.seed + entry * ENTRY_STREAM;
+    while (entry > 0 and next_random(state) < duplicate_threshold) {
+        entry = (static_cast<unsigned __int128>(next_random(state)) *
+                 entry) >> 64;
+        state = options.seed + entry * ENTRY_STREAM;
+    }
+
+    size_t num_qs = options.num_questions;
+    memset(row, 0, (num_qs + 63) / 64 * sizeof(uint64_t));
+    size_t cluster = 0;
+    uint64_t cluster_draw = 0;
+    for (size_t q = 0; q < num_qs; q++) {
+        uint64_t draw;
+        if (options.clusters == 0) {
+            draw = next_random(state);
+        } else {
+            size_t q_cluster = q * options.clusters / num_qs;
+            if (q == 0 or q_cluster != cluster) {
+                cluster = q_cluster;
+                cluster_draw = next_random(state);
+            }
+            draw = next_random(state) < correlation_threshold ?
+                   cluster_draw : next_random(state);
+        }
+        if (draw < thresholds[q]) {
+            row[q >> 6] |= 1ULL << (q & 63);
+        }
+    }
+}
+
+// Function run_batches
+// Parameters: The range [first, last) of the entries to work on, the number
+//             of entries in a batch, and a function that does the work of
+//             the batch [begin, end)
+// Returns:    None
+// Does:       Cuts the range into batches and runs the function on each, as
+//             tasks of the pool if there is one, and returns once all of them
+//             have finished
+void catalogGenerator::run_batches(size_t first, size_t last,
+                                   size_t batch_size,
+                                   function<void(size_t, size_t)> work)
+{
+    atomic<int> pending(0);
+    for (size_t begin = first; begin < last; begin += batch_size) {
+        size_t end = begin + batch_size < last ? begin + batch_size : last;
+        if (workers == nullptr) {
+            work(begin, end);
+        } else {
+            workers->spawn([begin, end, &work]() { work(begin, end); },
+                           pending);
+        }
+    }
+    if (workers != nullptr) {
+        workers->wait(pending);
+    }
+}
+
+// Function threshold_of
+// Parameters: A chance, from 0 to 1
+// Returns:    The number that a random 64 bit number is below with that
+//             chance. Chances outside of 0 to 1 are taken to be 0 or 1
+uint64_t catalogGenerator::threshold_of(double chance)
+{
+    double threshold = chance * 18446744073709551616.0;
+    if (not (threshold > 0)) {
+        return 0;
+    } else if (threshold >= 18446744073709551616.0) {
+        return UINT64_MAX;
+    }
+    return static_cast<uint64_t>(threshold);
+}
+
+// Function next_random
+// Parameters: The state of a generator, passed by reference
+// Returns:    The next 64 random bits
+// Does:       Steps a splitmix64 generator, the same one that the KDtree
+//             samples with
+uint64_t catalogGenerator::next_random(uint64_t &state)
+{
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,97 @@
+// catalogGenerator.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the catalogGenerator class, which makes up a catalog
+//          of entries and questions of any size, for measuring how the tree
+//          and the neighbor index scale far beyond the catalogs that come
+//          with the game. Every question has a chance of being answered yes
+//          of its own, questions can be grouped into clusters whose answers
+//          tend to agree, and a share of the entries can copy the answers of
+//          an earlier entry. The catalog is written as an entries file and a
+//          questions file, or as a dataset file. Every row of answers is made
+//          from the seed and the entry's index alone, so the same settings
+//          always make the same catalog, however many threads make it, and
+//          the text files are written a batch of rows at a time, without the
+//          whole catalog ever being held in memory
+//
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <stdint.h>
+#include "taskPool.h"
+#include "questions_and_entries.h"
+#include "answerMatrix.h"
+
+using namespace std;
+
+#ifndef _CATALOGGENERATOR_H_
+#define _CATALOGGENERATOR_H_
+
+struct GeneratorOptions {
+    size_t num_entries;
+    size_t num_questions;
+    // Every question's chance of a yes is drawn evenly from yes_rate less
+    // yes_spread to yes_rate plus yes_spread
+    double yes_rate;
+    double yes_spread;
+    // The questions are split into this many clusters of neighboring
+    // questions, or none if it is zero. Each answer to a question in a
+    // cluster is, with a chance of correlation, drawn from the same number
+    // as the rest of the entry's answers in the cluster, and so agrees with
+    // them more often than chance. Its chance of a yes does not change
+    size_t clusters;
+    double correlation;
+    // The chance that an entry, other than the first, copies the answers of
+    // an earlier entry chosen at random
+    double duplicates;
+    uint64_t seed;
+    int threads;
+
+    GeneratorOptions()
+    {
+        num_entries = 0;
+        num_questions = 0;
+        yes_rate = 0.5;
+        yes_spread = 0;
+        clusters = 0;
+        correlation = 0.5;
+        duplicates = 0;
+        seed = 20;
+        threads = 1;
+    }
+};
+
+class catalogGenerator {
+public:
+    catalogGenerator(GeneratorOptions &options);
+    ~catalogGenerator();
+
+    void write_text(string entriesFile, string questionsFile);
+    void write_dataset(string datasetFileName);
+    void make(vector<Entry> &entries, vector<Question> &questions,
+              answerMatrix &answers);
+
+private:
+    GeneratorOptions options;
+    // A question is answered yes when a random 64 bit number is below its
+    // threshold
+    vector<uint64_t> thresholds;
+    uint64_t correlation_threshold;
+    uint64_t duplicate_threshold;
+    // The pool that batches of rows are made on, or nullptr for one thread
+    taskPool *workers;
+
+    string prompt();
+    string question_text(size_t q_index);
+    string entry_name(size_t entry);
+    void make_row(size_t entry, uint64_t *row);
+    void run_batches(size_t first, size_t last, size_t batch_size,
+                     function<void(size_t, size_t)> work);
+
+    static uint64_t threshold_of(double chance);
+    static uint64_t next_random(uint64_t &state);
+};
+
+#endif
@@ -0,0 +1,85 @@
+// dataset.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the dataset class
+//
+
+#include <functional>
+#include <utility>
+#include "dataset.h"
+
+using namespace std;
+
+static const int32_t NO_ENTRY = -1;
+
+// Constructor dataset
+// Parameters: The entries, questions and answers that were read, which are
+//             moved into the dataset and left empty, and whether the answers
+//             are needed as columns as well as rows
+// Does:       Takes over the contents, builds the columns of the answers if
+//             they are asked for and not there yet, and indexes the names
+dataset::dataset(vector<Entry> &&entries, vector<Question> &&questions,
+                 answerMatrix &&answers, bool with_columns)
+    : entriesVec(move(entries)), questionsVec(move(questions)),
+      answersMat(move(answers))
+{
+    if (with_columns and not answersMat.has_columns()) {
+        answersMat.build_columns();
+    }
+    build_name_index();
+}
+
+// Function build_name_index
+// Parameters: None
+// Returns:    None
+// Does:       Makes a table with at least twice as many slots as there are
+//             entries and puts every entry's index into it, in order, at the
+//             first empty slot at or after the one its name hashes to. Only
+//             the indices are stored, the names themselves are read from the
+//             entries when the table is searched
+void dataset::build_name_index()
+{
+    size_t num_slots = 16;
+    while (num_slots < 2 * entriesVec.size()) {
+        num_slots *= 2;
+    }
+    name_slots.assign(num_slots, NO_ENTRY);
+    name_mask = num_slots - 1;
+
+    for (size_t i = 0; i < entriesVec.size(); i++) {
+        size_t slot = name_slot(entriesVec[i].name);
+        while (name_slots[slot] != NO_ENTRY) {
+            slot = (slot + 1) & name_mask;
+        }
+        name_slots[slot] = static_cast<int32_t>(i);
+    }
+}
+
+// Function name_slot
+// Parameters: The name of an entry
+// Returns:    The slot of the name index that the name hashes to
+size_t dataset::name_slot(const string &name) const
+{
+    return hash<string>()(name) & name_mask;
+}
+
+// Function find_entries
+// Parameters: The name of an entry, and a vector of indices, passed by
+//             reference
+// Returns:    None
+// Does:       Sets ids to the index of every entry with that name, in
+//             increasing order, which is empty if there is none. Probes from
+//             the slot that the name hashes to until an empty slot is reached
+//             and since the entries were added in order, the ones with the
+//             name are met in order too
+void dataset::find_entries(const string &name, vector<int32_t> &ids) const
+{
+    ids.clear();
+    size_t slot = name_slot(name);
+    while (name_slots[slot] != NO_ENTRY) {
+        if (entriesVec[name_slots[slot]].name == name) {
+            ids.push_back(name_slots[slot]);
+        }
+        slot = (slot + 1) & name_mask;
+    }
+}
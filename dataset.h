@@ -0,0 +1,58 @@
+// dataset.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the dataset class, which holds the entries, the
+//          questions and the answerMatrix of a game once they have been read,
+//          along with a hash index from the name of an entry to its index. A
+//          dataset is never changed once it is made, and is handed around as
+//          a shared_ptr to a const dataset, so the KDtree, the hammingTrie
+//          and the game all read the same single copy of the names and
+//          answers, and it is freed when the last of them lets go of it
+//
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+#include "questions_and_entries.h"
+#include "answerMatrix.h"
+
+using namespace std;
+
+#ifndef _DATASET_H_
+#define _DATASET_H_
+
+class dataset {
+public:
+    dataset(vector<Entry> &&entries, vector<Question> &&questions,
+            answerMatrix &&answers, bool with_columns);
+
+    size_t num_entries() const { return entriesVec.size(); }
+    size_t num_questions() const { return questionsVec.size(); }
+    const string &entry_name(size_t entry) const
+    {
+        return entriesVec[entry].name;
+    }
+    const string &question(size_t question) const
+    {
+        return questionsVec[question].question;
+    }
+    const answerMatrix &answers() const { return answersMat; }
+
+    void find_entries(const string &name, vector<int32_t> &ids) const;
+
+private:
+    vector<Entry> entriesVec;
+    vector<Question> questionsVec;
+    answerMatrix answersMat;
+
+    // Open-addressed table of entry indices, placed by the hash of their
+    // names, with -1 in the empty slots
+    vector<int32_t> name_slots;
+    size_t name_mask;
+
+    void build_name_index();
+    size_t name_slot(const string &name) const;
+};
+
+#endif
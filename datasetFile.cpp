@@ -0,0 +1,172 @@
+// datasetFile.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the datasetFile class
+//
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include "datasetFile.h"
+
+using namespace std;
+
+static const char DATASET_FILE_MAGIC[8] = { '2', '0', 'Q', 'D', 'A', 'T', 'A',
+                                            '\0' };
+
+// Constructor datasetFile
+// Does: Initializes a datasetFile that has not mapped any file yet
+datasetFile::datasetFile() : file("dataset file")
+{
+    header = nullptr;
+}
+
+// Function write
+// Parameters: The name of the file to write, the prompt, the questions, the
+//             entries and the matrix of their answers
+// Returns:    None
+// Does:       Writes the header, then the columns of the answers, then the
+//             string table as a vector of offsets followed by the bytes of
+//             the strings themselves. The strings are the prompt, then each
+//             question, then each entry name. The header is a multiple of 8
+//             bytes long, as is every column, so the columns and the offsets
+//             can be read in place. Builds the columns first if the matrix
+//             does not have them yet. Prints an error and exits if the file
+//             cannot be written
+void datasetFile::write(string filename, string prompt,
+                        vector<Question> &questions, vector<Entry> &entries,
+                        answerMatrix &answers)
+{
+    if (not answers.has_columns()) {
+        answers.build_columns();
+    }
+
+    vector<uint64_t> string_offsets;
+    uint64_t string_bytes = 0;
+    string_offsets.push_back(string_bytes);
+    string_bytes += prompt.size();
+    for (size_t i = 0; i < questions.size(); i++) {
+        string_offsets.push_back(string_bytes);
+        string_bytes += questions[i].question.size();
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        string_offsets.push_back(string_bytes);
+        string_bytes += entries[i].name.size();
+    }
+    string_offsets.push_back(string_bytes);
+
+    Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, DATASET_FILE_MAGIC, sizeof(h.magic));
+    h.byte_order = BYTE_ORDER_MARK;
+    h.format = DATASET_FILE_FORMAT;
+    h.num_entries = static_cast<uint32_t>(entries.size());
+    h.num_questions = static_cast<uint32_t>(questions.size());
+    h.num_answers = static_cast<uint32_t>(answers.num_questions());
+    h.column_words = static_cast<uint32_t>(answers.words_per_column());
+
+    uint64_t column_section = static_cast<uint64_t>(h.num_answers) *
+                              h.column_words * sizeof(uint64_t);
+    h.columns_offset = sizeof(Header);
+    h.string_offsets_offset = h.columns_offset + column_section;
+    h.strings_offset = h.string_offsets_offset +
+                       string_offsets.size() * sizeof(uint64_t);
+    h.strings_bytes = string_bytes;
+    h.file_bytes = h.strings_offset + string_bytes;
+
+    ofstream out(filename.c_str(), ios::binary | ios::trunc);
+    if (not out.is_open()) {
+        cerr << "Error opening dataset file for writing: " << filename
+             << endl;
+        exit(1);
+    }
+
+    out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    if (h.num_answers > 0) {
+        out.write(reinterpret_cast<const char *>(answers.column(0)),
+                  column_section);
+    }
+    out.write(reinterpret_cast<const char *>(string_offsets.data()),
+              string_offsets.size() * sizeof(uint64_t));
+    out.write(prompt.data(), prompt.size());
+    for (size_t i = 0; i < questions.size(); i++) {
+        out.write(questions[i].question.data(),
+                  questions[i].question.size());
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        out.write(entries[i].name.data(), entries[i].name.size());
+    }
+
+    if (not out.good()) {
+        cerr << "Error writing dataset file: " << filename << endl;
+        exit(1);
+    }
+    out.close();
+}
+
+// Function map
+// Parameters: The name of a file written by write
+// Returns:    None
+// Does:       Maps the whole file read-only into memory, and has the
+//             mappedFile check its prefix and string table. Then checks that
+//             the columns are as long as the entries need, and lie inside
+//             the file, before the string table. Prints an error and exits
+//             if the file cannot be used
+void datasetFile::map(string filename)
+{
+    file.map(filename, DATASET_FILE_MAGIC, DATASET_FILE_FORMAT, 
+             sizeof(Header));
+    // The file is read from front to back exactly once
+    file.read_once();
+    header = reinterpret_cast<const Header *>(file.bytes());
+
+    const Header &h = *header;
+    uint64_t num_strings = 1 + static_cast<uint64_t>(h.num_questions) +
+                           h.num_entries;
+    file.check_strings(h.string_offsets_offset, num_strings,
+                       h.strings_offset, h.strings_bytes, h.file_bytes);
+    if (h.columns_offset < sizeof(Header) or
+        h.column_words != (h.num_entries + 63) / 64 or
+        h.columns_offset + static_cast<uint64_t>(h.num_answers) *
+            h.column_words * sizeof(uint64_t) > h.string_offsets_offset) {
+        file.fail("has overlapping sections");
+    }
+}
+
+uint32_t datasetFile::num_entries() const { return header->num_entries; }
+uint32_t datasetFile::num_questions() const { return header->num_questions; }
+uint32_t datasetFile::num_answers() const { return header->num_answers; }
+uint32_t datasetFile::column_words() const { return header->column_words; }
+
+// Function columns
+// Returns: A pointer to the first word of the mapped columns, laid out in the
+//          same way as the columns of an answerMatrix
+const uint64_t *datasetFile::columns() const
+{
+    return reinterpret_cast<const uint64_t *>(file.bytes() +
+                                              header->columns_offset);
+}
+
+// Function prompt
+// Returns: The prompt, the first line of the questions file
+string datasetFile::prompt() const
+{
+    return file.string_at(0);
+}
+
+// Function question
+// Parameters: The index of a question
+// Returns:    The text of that question
+string datasetFile::question(size_t q_index) const
+{
+    return file.string_at(1 + q_index);
+}
+
+// Function entry_name
+// Parameters: The index of an entry
+// Returns:    The name of that entry
+string datasetFile::entry_name(size_t entry_index) const
+{
+    return file.string_at(1 + header->num_questions + entry_index);
+}
@@ -0,0 +1,72 @@
+// datasetFile.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the datasetFile class, which converts a pair of
+//          entries and questions text files into a single binary file and
+//          maps such a file back into memory. The answers are kept as the
+//          question-major columns of an answerMatrix, one bitset over the
+//          entries per question, followed by a string table of the prompt,
+//          the questions and the entry names. Loading one of these files is
+//          a copy of the columns and of the strings, with nothing to parse.
+//          The mapping, the header's prefix and the string table are checked
+//          by a mappedFile, and the columns here
+//
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+#include "questions_and_entries.h"
+#include "answerMatrix.h"
+#include "mappedFile.h"
+
+using namespace std;
+
+#ifndef _DATASETFILE_H_
+#define _DATASETFILE_H_
+
+// Bumped whenever the layout of the file changes
+const uint32_t DATASET_FILE_FORMAT = 1;
+
+class datasetFile {
+public:
+    datasetFile();
+
+    static void write(string filename, string prompt,
+                      vector<Question> &questions, vector<Entry> &entries,
+                      answerMatrix &answers);
+
+    void map(string filename);
+
+    uint32_t num_entries() const;
+    uint32_t num_questions() const;
+    uint32_t num_answers() const;
+    uint32_t column_words() const;
+
+    const uint64_t *columns() const;
+
+    string prompt() const;
+    string question(size_t q_index) const;
+    string entry_name(size_t entry_index) const;
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t byte_order;
+        uint32_t format;
+        uint32_t num_entries;
+        uint32_t num_questions;
+        uint32_t num_answers;
+        uint32_t column_words;
+        uint64_t columns_offset;
+        uint64_t string_offsets_offset;
+        uint64_t strings_offset;
+        uint64_t strings_bytes;
+        uint64_t file_bytes;
+    };
+
+    mappedFile file;
+    const Header *header;
+};
+
+#endif
@@ -0,0 +1,316 @@
+// entriesParser.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the fast parser for entries text files
+//
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "entriesParser.h"
+#include "taskPool.h"
+
+using namespace std;
+
+// Files are only cut into more than one chunk per thread when every chunk
+// would still be at least this many bytes long
+static const size_t MIN_CHUNK_BYTES = 1 << 20;
+static const int CHUNKS_PER_THREAD = 4;
+
+static const size_t NO_ENTRY = static_cast<size_t>(-1);
+
+// The part of the file that one task parses, starting on a name line
+struct Chunk {
+    const char *begin;
+    const char *end;
+    // Index of the first entry in the chunk
+    size_t first_entry;
+    // Newlines in the chunk, counted before it is moved to a name line
+    size_t newlines;
+    // The first entry in the chunk whose row has the wrong number of
+    // answers, or NO_ENTRY, and how many answers that row had
+    size_t bad_entry;
+    size_t bad_count;
+};
+
+// Function line_end
+// Parameters: Pointers to the start of a line and to the end of the file
+// Returns:    A pointer to the newline that ends the line, or to the end of
+//             the file if it is the last line and has no newline
+static const char *line_end(const char *p, const char *end)
+{
+    const char *nl = static_cast<const char *>(memchr(p, '\n', end - p));
+    return nl == nullptr ? end : nl;
+}
+
+// Function count_newlines
+// Parameters: Pointers to the start and the end of a range of the file
+// Returns:    The number of newlines in the range
+static size_t count_newlines(const char *p, const char *end)
+{
+    size_t count = 0;
+    while ((p = static_cast<const char *>(memchr(p, '\n', end - p))) !=
+           nullptr) {
+        count++;
+        p++;
+    }
+    return count;
+}
+
+// Function is_space
+// Parameters: A character
+// Returns:    A bool, true for the whitespace that a stringstream skips
+//             between integers, other than the newline that ends a line
+static bool is_space(char c)
+{
+    return c == ' ' or c == '\t' or c == '\r' or c == '\v' or c == '\f';
+}
+
+// Function scan_row
+// Parameters: Pointers to the start and the end of a line of answers, the
+//             row to set the bits of, which is all zeros, and its width
+// Returns:    The number of integers on the line
+// Does:       Reads one integer at a time, with an optional sign, setting the
+//             row's bit for every integer that is not zero. Stops at the end
+//             of the line or at the first thing that is not an integer.
+//             Integers past the width of the row are counted but not stored
+static size_t scan_row(const char *p, const char *end, uint64_t *row,
+                       size_t width)
+{
+    size_t count = 0;
+    while (true) {
+        while (p < end and is_space(*p)) {
+            p++;
+        }
+        if (p < end and (*p == '-' or *p == '+')) {
+            p++;
+        }
+        bool non_zero = false;
+        const char *digits = p;
+        while (p < end and *p >= '0' and *p <= '9') {
+            non_zero = non_zero or *p != '0';
+            p++;
+        }
+        if (p == digits) {
+            // Either the end of the line or something that is not an integer
+            return count;
+        }
+        if (non_zero and count < width) {
+            row[count >> 6] |= static_cast<uint64_t>(1) << (count & 63);
+        }
+        count++;
+    }
+}
+
+// Function parse_chunk
+// Parameters: A Chunk, passed by reference, the width that every row must
+//             have, and the entries and answers to write into
+// Returns:    None
+// Does:       Reads the chunk one pair of lines at a time, the name of an
+//             entry and then its answers, into the entry's place in the
+//             vector and its row in the matrix. Stops at the first row with
+//             the wrong number of answers, recording it in the Chunk
+static void parse_chunk(Chunk &chunk, size_t width, vector<Entry> &entries,
+                        answerMatrix &answers)
+{
+    const char *p = chunk.begin;
+    size_t e = chunk.first_entry;
+    while (p < chunk.end) {
+        const char *name_end = line_end(p, chunk.end);
+        entries[e].name.assign(p, name_end);
+        p = name_end < chunk.end ? name_end + 1 : name_end;
+
+        const char *answers_end = line_end(p, chunk.end);
+        size_t count = scan_row(p, answers_end, answers.mutable_row(e),
+                                width);
+        p = answers_end < chunk.end ? answers_end + 1 : answers_end;
+
+        if (count != width) {
+            chunk.bad_entry = e;
+            chunk.bad_count = count;
+            return;
+        }
+        e++;
+    }
+}
+
+// Function run_chunks
+// Parameters: The chunks, a pool to run them on or nullptr, and a function
+//             that does the work of one chunk
+// Returns:    None
+// Does:       Runs the function on every chunk, as tasks of the pool if there
+//             is one, and returns once all of them have finished
+static void run_chunks(vector<Chunk> &chunks, taskPool *workers,
+                       function<void(Chunk &)> work)
+{
+    if (workers == nullptr) {
+        for (size_t i = 0; i < chunks.size(); i++) {
+            work(chunks[i]);
+        }
+        return;
+    }
+    atomic<int> pending(0);
+    for (size_t i = 0; i < chunks.size(); i++) {
+        Chunk *chunk = &chunks[i];
+        workers->spawn([chunk, &work]() { work(*chunk); }, pending);
+    }
+    workers->wait(pending);
+}
+
+// Function split_chunks
+// Parameters: The mapped file and its size, the number of chunks to make,
+//             and a pool to count their newlines on
+// Returns:    The chunks, each starting on the name line of an entry
+// Does:       Cuts the file into equal ranges of bytes and counts the
+//             newlines in each range in parallel. The running total of those
+//             counts gives the line that each range starts in, which is
+//             enough to move the start of every range forward to the next
+//             line, and then, if that is a line of answers, one line further
+//             to a name line
+static vector<Chunk> split_chunks(const char *data, size_t size,
+                                  size_t num_chunks, taskPool *workers)
+{
+    vector<Chunk> chunks(num_chunks);
+    for (size_t i = 0; i < num_chunks; i++) {
+        chunks[i].begin = data + size * i / num_chunks;
+        chunks[i].end = data + size * (i + 1) / num_chunks;
+        chunks[i].bad_entry = NO_ENTRY;
+        chunks[i].bad_count = 0;
+    }
+    run_chunks(chunks, workers, [](Chunk &chunk) {
+        chunk.newlines = count_newlines(chunk.begin, chunk.end);
+    });
+
+    const char *end = data + size;
+    size_t lines_before = 0;
+    const char *previous_begin = data;
+    size_t previous_line = 0;
+    for (size_t i = 0; i < num_chunks; i++) {
+        const char *begin = chunks[i].begin;
+        size_t line = lines_before;
+        lines_before += chunks[i].newlines;
+
+        if (begin > data and begin[-1] != '\n') {
+            begin = line_end(begin, end);
+            if (begin < end) {
+                begin++;
+            }
+            line++;
+        }
+        if (line % 2 == 1 and begin < end) {
+            begin = line_end(begin, end);
+            if (begin < end) {
+                begin++;
+            }
+            line++;
+        }
+        // A single long line can swallow more than one range
+        if (begin < previous_begin) {
+            begin = previous_begin;
+            line = previous_line;
+        }
+        chunks[i].begin = begin;
+        chunks[i].first_entry = line / 2;
+        previous_begin = begin;
+        previous_line = line;
+    }
+    for (size_t i = 0; i + 1 < num_chunks; i++) {
+        chunks[i].end = chunks[i + 1].begin;
+    }
+    chunks[num_chunks - 1].end = end;
+    return chunks;
+}
+
+// Function parse_entries_file
+// Parameters: The name of an entries file, the number of threads to parse it
+//             with, and the vector of entries and the answerMatrix to fill,
+//             both of which are empty
+// Returns:    A bool, false if the file could not be mapped, in which case it
+//             should be read as a stream instead, and true once it has been
+//             parsed
+// Does:       Maps the file, and counts its lines to learn how many entries
+//             it holds. The first row of answers decides how many answers
+//             every entry has, so it is scanned first, and then every entry's
+//             name and row are made ahead of time so that the chunks can be
+//             parsed straight into them in parallel. A row of a different
+//             length is an error, reported for the first such entry in the
+//             file
+bool parse_entries_file(string entriesFile, int num_threads,
+                        vector<Entry> &entries, answerMatrix &answers)
+{
+    int fd = open(entriesFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 or not S_ISREG(info.st_mode)) {
+        close(fd);
+        return false;
+    }
+    size_t size = info.st_size;
+    if (size == 0) {
+        close(fd);
+        return true;
+    }
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    const char *data = static_cast<const char *>(mapped);
+    const char *end = data + size;
+
+    size_t num_chunks = 1;
+    taskPool *workers = nullptr;
+    if (num_threads > 1 and size >= 2 * MIN_CHUNK_BYTES) {
+        num_chunks = min(static_cast<size_t>(num_threads) * CHUNKS_PER_THREAD,
+                         size / MIN_CHUNK_BYTES);
+        workers = new taskPool(num_threads);
+    }
+    vector<Chunk> chunks = split_chunks(data, size, num_chunks, workers);
+
+    size_t num_lines = 0;
+    for (size_t i = 0; i < num_chunks; i++) {
+        num_lines += chunks[i].newlines;
+    }
+    if (end[-1] != '\n') {
+        num_lines++;
+    }
+    size_t num_entries = (num_lines + 1) / 2;
+
+    // The width of the first row, found without storing it
+    const char *first_answers = line_end(data, end);
+    if (first_answers < end) {
+        first_answers++;
+    }
+    uint64_t ignored = 0;
+    size_t width = scan_row(first_answers, line_end(first_answers, end),
+                            &ignored, 0);
+
+    answers.set_num_questions(width);
+    answers.add_rows(num_entries);
+    entries.resize(num_entries);
+
+    run_chunks(chunks, workers, [&](Chunk &chunk) {
+        parse_chunk(chunk, width, entries, answers);
+    });
+    delete workers;
+    munmap(mapped, size);
+
+    for (size_t i = 0; i < num_chunks; i++) {
+        if (chunks[i].bad_entry != NO_ENTRY) {
+            cerr << "Entry " << entries[chunks[i].bad_entry].name << " has "
+                 << chunks[i].bad_count << " answers, expected " << width
+                 << endl;
+            exit(1);
+        }
+    }
+    return true;
+}
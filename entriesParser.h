@@ -0,0 +1,29 @@
+// entriesParser.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the fast parser for entries text files. The file is
+//          mapped into memory and cut into chunks that each start on the name
+//          line of an entry, and the chunks are parsed by the threads of a
+//          taskPool, each writing its entries' names and answer rows straight
+//          into their places in the entries vector and the answerMatrix. The
+//          answers are read by a small hand-written scanner rather than by a
+//          stringstream, but they are read the same way: each line of
+//          answers is a list of whitespace separated integers that ends at
+//          the first thing that is not one, and every non-zero integer is a
+//          yes
+//
+
+#include <string>
+#include <vector>
+#include "questions_and_entries.h"
+#include "answerMatrix.h"
+
+using namespace std;
+
+#ifndef _ENTRIESPARSER_H_
+#define _ENTRIESPARSER_H_
+
+bool parse_entries_file(string entriesFile, int num_threads,
+                        vector<Entry> &entries, answerMatrix &answers);
+
+#endif
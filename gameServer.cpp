@@ -0,0 +1,432 @@
+// gameServer.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the gameServer class
+//
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "gameServer.h"
+#include "gameSession.h"
+#include "TwentyQgame.h"
+
+using namespace std;
+
+// A connection that sends a longer line than this without a newline is
+// closed, so that no player can make the server hold on to unbounded input
+static const size_t MAX_LINE = 4096;
+// Lines are no longer answered once a connection has this much text waiting
+// to be sent, and the connection is not read again until all of it has
+// been, so that a player who sends but never reads cannot make the server
+// queue unbounded output
+static const size_t MAX_OUTPUT = 65536;
+static const int MAX_EVENTS = 256;
+
+// Set by the handler of SIGINT and SIGTERM to stop the server
+static volatile sig_atomic_t stop_requested = 0;
+
+// Function request_stop
+// Parameters: The number of the signal that was caught
+// Returns:    None
+static void request_stop(int)
+{
+    stop_requested = 1;
+}
+
+// Constructor gameServer
+// Parameters: The TwentyQgame to serve, passed by reference, whose tree, and
+//             neighbor index for version 3.0, must already have been made
+// Does:       Sets up a server that is not listening yet
+gameServer::gameServer(TwentyQgame &game)
+{
+    this->game = &game;
+    listen_fd = -1;
+    epoll_fd = -1;
+    accepting = false;
+}
+
+// Destructor ~gameServer
+// Does: Closes every connection and the listening socket, and removes the
+//       Unix-domain socket from the file system
+gameServer::~gameServer()
+{
+    for (size_t fd = 0; fd < connections.size(); fd++) {
+        if (connections[fd] != nullptr) {
+            close_connection(connections[fd]);
+        }
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+    }
+    if (not socket_path.empty()) {
+        unlink(socket_path.c_str());
+    }
+}
+
+// Function listen
+// Parameters: The address to listen on, either a port number, for a TCP
+//             port of the loopback address, or the path of a Unix-domain
+//             socket
+// Returns:    None
+// Does:       Opens the listening socket and the epoll instance that waits on
+//             it and on every connection. Exits if either cannot be opened
+void gameServer::listen(string address)
+{
+    raise_file_limit();
+    if (not address.empty() and
+        address.find_first_not_of("0123456789") == string::npos) {
+        long port = strtol(address.c_str(), nullptr, 10);
+        if (port < 1 or port > 65535) {
+            cerr << "Invalid port to serve on: " << address << endl;
+            exit(1);
+        }
+        listen_tcp(static_cast<int>(port));
+    } else {
+        listen_unix(address);
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        cerr << "Could not create an epoll instance: " << strerror(errno)
+             << endl;
+        exit(1);
+    }
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+    accepting = true;
+    cout << "Serving on " << address << endl;
+}
+
+// Function listen_tcp
+// Parameters: A port number
+// Returns:    None
+// Does:       Listens on the port of the loopback address only, so that the
+//             server cannot be reached from another machine
+void gameServer::listen_tcp(int port)
+{
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                       0);
+    int reuse = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (listen_fd < 0 or
+        bind(listen_fd, reinterpret_cast<sockaddr *>(&addr),
+             sizeof(addr)) < 0 or
+        ::listen(listen_fd, SOMAXCONN) < 0) {
+        cerr << "Could not listen on port " << port << ": "
+             << strerror(errno) << endl;
+        exit(1);
+    }
+}
+
+// Function listen_unix
+// Parameters: The path of the socket
+// Returns:    None
+// Does:       Listens on a Unix-domain socket at the path, replacing a socket
+//             that was left there by a server that did not stop cleanly. Any
+//             other kind of file at the path is left alone, and is an error
+void gameServer::listen_unix(string path)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() or path.size() >= sizeof(addr.sun_path)) {
+        cerr << "Invalid socket path to serve on: " << path << endl;
+        exit(1);
+    }
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 and S_ISSOCK(info.st_mode)) {
+        unlink(path.c_str());
+    }
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                       0);
+    if (listen_fd < 0 or
+        bind(listen_fd, reinterpret_cast<sockaddr *>(&addr),
+             sizeof(addr)) < 0 or
+        ::listen(listen_fd, SOMAXCONN) < 0) {
+        cerr << "Could not listen on " << path << ": " << strerror(errno)
+             << endl;
+        exit(1);
+    }
+    socket_path = path;
+}
+
+// Function raise_file_limit
+// Parameters: None
+// Returns:    None
+// Does:       Raises the number of files that the process may have open to
+//             the most it is allowed, since every connection is a file
+void gameServer::raise_file_limit()
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 and
+        limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+// Function run
+// Parameters: None
+// Returns:    None
+// Does:       Waits for sockets to be ready and serves them, until the server
+//             is sent SIGINT or SIGTERM. A connection that was closed while
+//             serving an earlier event of the same wait is skipped
+void gameServer::run()
+{
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    epoll_event events[MAX_EVENTS];
+    while (not stop_requested) {
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (ready < 0 and errno == EINTR) {
+            continue;
+        } else if (ready < 0) {
+            cerr << "Could not wait on the connections: " << strerror(errno)
+                 << endl;
+            exit(1);
+        }
+
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listen_fd) {
+                accept_connections();
+                continue;
+            }
+            if (static_cast<size_t>(fd) >= connections.size() or
+                connections[fd] == nullptr) {
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                read_connection(connections[fd]);
+            }
+            if ((events[i].events & EPOLLOUT) and
+                connections[fd] != nullptr) {
+                write_connection(connections[fd]);
+            }
+        }
+    }
+}
+
+// Function accept_connections
+// Parameters: None
+// Returns:    None
+// Does:       Accepts every connection that is waiting, starting a game on
+//             each of them and sending its welcome. If the process has run
+//             out of files, stops watching the listening socket until a
+//             connection is closed, rather than being woken for it over and
+//             over again
+void gameServer::accept_connections()
+{
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0 and errno == EINTR) {
+            continue;
+        } else if (fd < 0 and (errno == EMFILE or errno == ENFILE)) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, listen_fd, nullptr);
+            accepting = false;
+            return;
+        } else if (fd < 0) {
+            return;
+        }
+
+        if (socket_path.empty()) {
+            int no_delay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+                       sizeof(no_delay));
+        }
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+
+        if (static_cast<size_t>(fd) >= connections.size()) {
+            connections.resize(fd + 1, nullptr);
+        }
+        Connection *conn = new Connection(fd, *game);
+        connections[fd] = conn;
+        conn->output = conn->session.start();
+        write_connection(conn);
+    }
+}
+
+// Function read_connection
+// Parameters: A pointer to a Connection that is ready to be read
+// Returns:    None
+// Does:       Reads what has arrived and answers the whole lines of it, in
+//             order, then sends what the game had to say back. Closes the
+//             connection once the player has closed their end, or if their
+//             line grows too long
+void gameServer::read_connection(Connection *conn)
+{
+    char buffer[4096];
+    ssize_t got = read(conn->fd, buffer, sizeof(buffer));
+    if (got < 0 and (errno == EAGAIN or errno == EWOULDBLOCK or
+                     errno == EINTR)) {
+        return;
+    } else if (got <= 0) {
+        close_connection(conn);
+        return;
+    }
+
+    conn->input.append(buffer, got);
+    answer_lines(conn);
+    if (conn->input.size() > MAX_LINE and
+        conn->input.find('\n') == string::npos) {
+        close_connection(conn);
+        return;
+    }
+    write_connection(conn);
+}
+
+// Function answer_lines
+// Parameters: A pointer to a Connection
+// Returns:    None
+// Does:       Answers the whole lines that the connection has sent, in order,
+//             until its game is over or MAX_OUTPUT of text is waiting to be
+//             sent. The lines that are left are answered once it has been
+void gameServer::answer_lines(Connection *conn)
+{
+    size_t start = 0, newline;
+    while (conn->output.size() < MAX_OUTPUT and
+           not conn->session.finished() and
+           (newline = conn->input.find('\n', start)) != string::npos) {
+        answer_line(conn, conn->input.substr(start, newline - start));
+        start = newline + 1;
+    }
+    conn->input.erase(0, start);
+}
+
+// Function answer_line
+// Parameters: A pointer to a Connection and a line that it sent
+// Returns:    None
+// Does:       Gives the first word of the line to the game as its answer,
+//             and queues the game's reply. Blank lines are skipped, as they
+//             are when the game reads from standard input
+void gameServer::answer_line(Connection *conn, string line)
+{
+    const char *spaces = " \t\r\v\f";
+    size_t first = line.find_first_not_of(spaces);
+    if (first == string::npos) {
+        return;
+    }
+    size_t last = line.find_first_of(spaces, first);
+    string word = line.substr(first, last == string::npos ? string::npos
+                                                          : last - first);
+    conn->output += conn->session.answer(word);
+}
+
+// Function write_connection
+// Parameters: A pointer to a Connection
+// Returns:    A bool, false if the connection was closed
+// Does:       Sends as much of the connection's queued text as the socket
+//             will take, answering the lines that were held back as it goes.
+//             Whatever is left is sent once the socket is ready for it again.
+//             Closes the connection once its game is over and everything has
+//             been sent, or if the player has gone
+bool gameServer::write_connection(Connection *conn)
+{
+    while (not conn->output.empty()) {
+        ssize_t sent = send(conn->fd, conn->output.data(),
+                            conn->output.size(), MSG_NOSIGNAL);
+        if (sent < 0 and errno == EINTR) {
+            continue;
+        } else if (sent < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) {
+            watch_writes(conn, true);
+            return true;
+        } else if (sent < 0) {
+            close_connection(conn);
+            return false;
+        }
+        conn->output.erase(0, sent);
+        if (conn->output.empty()) {
+            answer_lines(conn);
+        }
+    }
+    watch_writes(conn, false);
+    if (conn->session.finished()) {
+        close_connection(conn);
+        return false;
+    }
+    return true;
+}
+
+// Function watch_writes
+// Parameters: A pointer to a Connection, and whether to be woken when it is
+//             ready to be written to
+// Returns:    None
+// Does:       Only watches for writes while there is text waiting to be sent,
+//             since a socket is almost always ready for them, and only for
+//             reads while there is not, so that nothing more is read from a
+//             player until they have taken what was sent to them
+void gameServer::watch_writes(Connection *conn, bool writing)
+{
+    if (conn->writing == writing) {
+        return;
+    }
+    epoll_event event;
+    event.events = writing ? EPOLLOUT : EPOLLIN;
+    event.data.fd = conn->fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+    conn->writing = writing;
+}
+
+// Function close_connection
+// Parameters: A pointer to a Connection, which is deleted
+// Returns:    None
+// Does:       Reads and throws away anything that the player has sent that
+//             was not read, so that closing the socket does not reset it and
+//             lose the last of what was sent to them, then closes it. Starts
+//             accepting connections again if it had stopped for want of files
+void gameServer::close_connection(Connection *conn)
+{
+    char buffer[4096];
+    while (read(conn->fd, buffer, sizeof(buffer)) > 0) {
+    }
+    close(conn->fd);
+    connections[conn->fd] = nullptr;
+    delete conn;
+
+    if (not accepting) {
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = listen_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+        accepting = true;
+    }
+}
@@ -0,0 +1,80 @@
+// gameServer.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the gameServer class, which plays many games of one
+//          TwentyQgame at once over a socket, so that the entries are loaded
+//          and the tree is built once however many players there are. It
+//          listens on a Unix-domain socket, or on a TCP port of the loopback
+//          address, and gives every connection a gameSession of its own.
+//          The protocol is the game's own text: the server sends what the
+//          game would have printed, and every line that the player sends
+//          back is one answer. A single thread waits on every socket at once
+//          with epoll, and only ever reads or writes a socket that is ready,
+//          so no player can hold up the others. A connection is not read
+//          from while it has text waiting to be sent, so a player who does
+//          not read holds on to no more than a bounded amount of memory. A
+//          connection is closed once its game is over and everything has
+//          been sent
+//
+
+#include <string>
+#include <vector>
+#include "TwentyQgame.h"
+#include "gameSession.h"
+
+using namespace std;
+
+#ifndef _GAMESERVER_H_
+#define _GAMESERVER_H_
+
+class gameServer {
+public:
+    gameServer(TwentyQgame &game);
+    ~gameServer();
+
+    void listen(string address);
+    void run();
+
+private:
+    struct Connection {
+        int fd;
+        gameSession session;
+        // The part of a line that has arrived without its newline yet, and
+        // the text that has not been sent yet
+        string input;
+        string output;
+        bool writing;
+
+        Connection(int fd, TwentyQgame &game) : fd(fd), session(game)
+        {
+            writing = false;
+        }
+    };
+
+    TwentyQgame *game;
+    int listen_fd;
+    int epoll_fd;
+    // False while the listening socket is not watched, because the process
+    // ran out of files to accept connections with
+    bool accepting;
+    // The path of the Unix-domain socket, which is removed when the server
+    // stops, or empty when listening on a TCP port
+    string socket_path;
+    // The open connections, indexed by their file descriptors, with nullptr
+    // for every descriptor that is not a connection
+    vector<Connection *> connections;
+
+    void listen_tcp(int port);
+    void listen_unix(string path);
+    void raise_file_limit();
+
+    void accept_connections();
+    void read_connection(Connection *conn);
+    void answer_lines(Connection *conn);
+    void answer_line(Connection *conn, string line);
+    bool write_connection(Connection *conn);
+    void watch_writes(Connection *conn, bool writing);
+    void close_connection(Connection *conn);
+};
+
+#endif
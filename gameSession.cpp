@@ -0,0 +1,454 @@
+// gameSession.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the gameSession class. Each version's game is
+//          the loop that it was when it read from standard input, cut apart
+//          at every place where it read an answer: the _next function of a
+//          version is the top of its loop, which returns the next question
+//          or guess, and its _answer function is the rest of the loop body,
+//          run once the answer has arrived. Because a game is always stopped
+//          at one of those places between answers, its phase, its count of
+//          guesses and its cursor on the tree are all there is to save
+//
+
+#include <string>
+#include "gameSession.h"
+#include "TwentyQgame.h"
+#include "KDtree.h"
+#include "hammingTrie.h"
+#include "userInput.h"
+#include "runStats.h"
+
+using namespace std;
+
+// The first byte of a saved game, which changes whenever the format does so
+// that games saved in an old format are turned away
+static const uint8_t SESSION_FORMAT = 1;
+
+// Constructor gameSession
+// Parameters: The TwentyQgame to play, passed by reference, whose tree and
+//             neighbor index are shared with every other gameSession of it
+// Does:       Sets up a game that has not been started yet
+gameSession::gameSession(TwentyQgame &game)
+{
+    this->game = &game;
+    phase = WELCOME;
+    guesses_made = 0;
+    neighbors_given = 0;
+}
+
+// Function start
+// Parameters: None
+// Returns:    The welcome message, which varies in accordance to the version
+//             which we are running, and the instruction to begin
+string gameSession::start()
+{
+    phase = WELCOME;
+    guesses_made = 0;
+    neighbors_given = 0;
+    string welcome = "Welcome to 20 questions! Please think of a(n)\n" +
+                     game->prompt + "\n";
+    if (game->version_num != 2.0) {
+        welcome += "Respond to each of the following questions with (y/n)\n";
+    } else {
+        welcome += "Respond to each of the following questions with "
+                   "(y/n/prob/probnot/unknown)\n";
+    }
+    return welcome + begin_prompt();
+}
+
+// Function answer
+// Parameters: The player's answer to the text that was last returned
+// Returns:    The text to show the player next, which is empty once the game
+//             is over
+// Does:       Plays the game on until it next needs an answer. Every version
+//             but 2.0 only looks at the first character of an answer, and
+//             2.0 does too while it is being welcomed
+string gameSession::answer(const string &input)
+{
+    char command = input.empty() ? '\0' : input[0];
+    if (phase == DONE) {
+        return "";
+    } else if (phase == WELCOME) {
+        return welcome_answer(command);
+    } else if (game->version_num < 2.0) {
+        return proto_answer(command);
+    } else if (game->version_num == 2.0) {
+        return prob_answer(input);
+    } else {
+        return neighbors_answer(command);
+    }
+}
+
+// Function answer
+// Parameters: The player's answer to a question or a guess, as a userInput
+// Returns:    The text to show the player next, which is empty once the game
+//             is over
+// Does:       Answers with the word that stands for the userInput. The 
+//             welcome asks for no userInput, so any answer to it begins the
+//             game
+string gameSession::answer(userInput input)
+{
+    static const char *const WORDS[] = { "y", "n", "prob", "probnot", 
+                                         "unknown" };
+    if (phase == WELCOME) {
+        return answer(string("B"));
+    }
+    return answer(string(WORDS[input]));
+}
+
+// Function save
+// Parameters: None
+// Returns:    The state of the game, as a string of bytes
+// Does:       Writes the format, the phase and the number of guesses made, 
+//             then, in the middle of a game, the number of neighbors that
+//             have been guessed and the state of the cursor. Only the number
+//             of neighbors is saved, not the neighbors themselves, since they
+//             can be found again from the entry that was guessed
+string gameSession::save()
+{
+    string state;
+    state += static_cast<char>(SESSION_FORMAT);
+    state += static_cast<char>(phase);
+    state += static_cast<char>(guesses_made);
+    if (phase == GUESSING_NEIGHBORS) {
+        state += static_cast<char>(neighbors_given);
+    }
+    if (phase != WELCOME and phase != DONE) {
+        cursor.save(state);
+    }
+    return state;
+}
+
+// Function restore
+// Parameters: A string of state written by save
+// Returns:    A bool, false if the state was not saved from a game of this
+//             version on this tree, or has been cut short or changed
+// Does:       Puts the session in the game that was saved, so that its next
+//             answer is the answer to the text that was last returned before
+//             it was saved. The session is left as it was if the state is bad
+bool gameSession::restore(const string &state)
+{
+    if (state.size() < 3 or 
+        static_cast<uint8_t>(state[0]) != SESSION_FORMAT) {
+        return false;
+    }
+    gameSession restored(*game);
+    int phase_num = static_cast<uint8_t>(state[1]);
+    restored.guesses_made = static_cast<uint8_t>(state[2]);
+    size_t at = 3;
+    if (phase_num > DONE or restored.guesses_made > 20) {
+        return false;
+    }
+    restored.phase = static_cast<Phase>(phase_num);
+
+    bool in_game = restored.phase != WELCOME and restored.phase != DONE;
+    if (in_game and game->version_num > 3.0) {
+        return false;
+    }
+    if (restored.phase == GUESSING_NEIGHBORS) {
+        if (game->version_num != 3.0 or at >= state.size()) {
+            return false;
+        }
+        restored.neighbors_given = static_cast<uint8_t>(state[at++]);
+        if (restored.neighbors_given < 1 or restored.guesses_made >= 20 or
+            restored.neighbors_given > restored.guesses_made) {
+            return false;
+        }
+    }
+    if (in_game) {
+        restored.cursor = game->make_tree()->start_game();
+        if (not restored.cursor.restore(state, at)) {
+            return false;
+        }
+    }
+    if (at != state.size()) {
+        return false;
+    }
+
+    if (restored.phase == GUESSING_NEIGHBORS) {
+        restored.restore_neighbors();
+    }
+    *this = restored;
+    return true;
+}
+
+// Function restore_neighbors
+// Parameters: None
+// Returns:    None
+// Does:       Finds the neighbors of the entry that was guessed again, as 
+//             many as there were guesses left after it, and takes as many of
+//             them as had been guessed, leaving the last one as the neighbor
+//             that is being guessed now
+void gameSession::restore_neighbors()
+{
+    int first_guesses = guesses_made - neighbors_given + 1;
+    neighbors = game->neighbor_index().find_nearest_of(cursor.entry_at_curr(),
+                                                       20 - first_guesses);
+    for (int i = 0; i < neighbors_given; i++) {
+        neighbor = neighbors.get_a_neighbor();
+    }
+}
+
+// Function finished
+// Parameters: None
+// Returns:    A bool, true once the game is over and wants no more answers
+bool gameSession::finished() const
+{
+    return phase == DONE;
+}
+
+// Function reads_words
+// Parameters: None
+// Returns:    A bool, true if the next answer is a whole word (y, n, prob,
+//             probnot or unknown), and false if only its first character is
+//             read
+bool gameSession::reads_words() const
+{
+    return game->version_num == 2.0 and phase != WELCOME;
+}
+
+// Function question_asked
+// Parameters: None
+// Returns:    The index of the question that the text last returned asked,
+//             or -1 if it asked no question, or asked one that the tree has
+//             run out of
+int gameSession::question_asked()
+{
+    return phase == ASKING ? cursor.question_index_at_curr() : -1;
+}
+
+// Function guess_made
+// Parameters: None
+// Returns:    The name of the entry that the text last returned guessed, or
+//             the empty string if it made no guess
+string gameSession::guess_made()
+{
+    if (phase == GUESSING) {
+        return cursor.entry_at_curr();
+    } else if (phase == GUESSING_NEIGHBORS) {
+        return neighbor;
+    }
+    return "";
+}
+
+// Function begin_prompt
+// Parameters: None
+// Returns:    The instruction to begin
+string gameSession::begin_prompt()
+{
+    return "Type B to begin or I for more information\n";
+}
+
+// Function welcome_answer
+// Parameters: The player's answer to the instruction to begin
+// Returns:    The text to show next
+// Does:       Starts the game on B, printing its first question, prints the
+//             acknowledgements on I, and asks again on anything else. The
+//             versions after 3.0 have no game yet, so they end here
+string gameSession::welcome_answer(char command)
+{
+    if (command == 'I') {
+        return ACKNOWLEDGEMENTS + "\n" + begin_prompt();
+    } else if (command != 'B') {
+        return begin_prompt();
+    }
+
+    cursor = game->make_tree()->start_game();
+    guesses_made = 0;
+    neighbors_given = 0;
+    runStats::add(runStats::GAMES_STARTED);
+    if (game->version_num < 2.0) {
+        return proto_next();
+    } else if (game->version_num == 2.0) {
+        return prob_next();
+    } else if (game->version_num == 3.0) {
+        return neighbors_next();
+    }
+    // I want to continue adding on to this project over winter break, so I
+    // left room for two more version ideas: one could be a hybrid between
+    // versions 2.0 and 3.0, and the other could be a sort of nueral network
+    // that changes the text files as it learns how people answer questions
+    return finish("");
+}
+
+// Function proto_next
+// Parameters: None
+// Returns:    The next question, or a guess once the pool has been narrowed
+//             down to a single entry
+// Does:       Asks the questions of the tree made from an instance of the
+//             KDtree class until there is just one entry that it has narrowed
+//             the pool to. This prototype version does nothing to account for
+//             the player making a mistake or possible dissent among what a
+//             question entails
+string gameSession::proto_next()
+{
+    if (cursor.can_ask()) {
+        phase = ASKING;
+        return cursor.question_at_curr() + "\n";
+    }
+    phase = GUESSING;
+    return "Are you thinking of " + cursor.entry_at_curr() + "?\n";
+}
+
+// Function proto_answer
+// Parameters: The player's answer, either 'y' or 'n'
+// Returns:    The text to show next
+// Does:       Advances in the direction of the answer, asking the same
+//             question again if it was neither, or ends the game once the
+//             guess has been answered
+string gameSession::proto_answer(char command)
+{
+    if (phase == GUESSING) {
+        return finish(command == 'y' ? "I win!!!"
+                                     : "You win, I am stumped...");
+    }
+    if (command == 'y' or command == 'n') {
+        cursor.advance(command == 'y');
+    }
+    return proto_next();
+}
+
+// Function prob_next
+// Parameters: None
+// Returns:    The next question or guess, numbered, or the message that the
+//             player has won once all 20 have been used
+// Does:       Version 2.0, where instead of merely yes or no, the user can
+//             enter probably, probably not, or unknown to give the program a
+//             better perspective on how polarizing that question was. Makes a
+//             guess whenever the pool has been narrowed down to one entry, 
+//             except before the first question, which is always asked
+string gameSession::prob_next()
+{
+    if (guesses_made >= 20) {
+        return finish("You win! I'm stumped.");
+    }
+    string text;
+    if (not cursor.can_ask() and guesses_made > 0) {
+        phase = GUESSING;
+        text = guess(cursor.entry_at_curr());
+    } else {
+        phase = ASKING;
+        text = numbered(cursor.question_at_curr());
+    }
+    guesses_made++;
+    return text;
+}
+
+// Function prob_answer
+// Parameters: The player's answer, a word
+// Returns:    The text to show next
+// Does:       Advances by the answer to a question. If a guess was wrong, the
+//             program can return to the state it was before a question was
+//             answered unknown or probably and try the opposite side of that
+//             question while rettaining the knowledge that it gained about
+//             definite yes and no answers, so that it won't re-ask the same
+//             question. If there is no probably or unknown to return to,
+//             then the player wins
+string gameSession::prob_answer(const string &command)
+{
+    if (phase == ASKING) {
+        cursor.advance_probably(TwentyQgame::string_to_UI(command));
+    } else if (command == "y") {
+        return finish("I win!!!");
+    } else if (not cursor.return_to_probably()) {
+        return finish("You win! I'm stumped.");
+    }
+    return prob_next();
+}
+
+// Function neighbors_next
+// Parameters: None
+// Returns:    The next question, numbered, or a guess
+// Does:       Runs in an identical fashion to version 1.0, execept here it
+//             tracks the number of questions that it has asked so it doesn't
+//             go over the maximum of 20. It stops asking before question 20
+//             because we want to make a guess and that counts
+string gameSession::neighbors_next()
+{
+    if (cursor.can_ask() and guesses_made < 19) {
+        phase = ASKING;
+        return numbered(cursor.question_at_curr());
+    }
+    phase = GUESSING;
+    return guess(cursor.entry_at_curr());
+}
+
+// Function neighbors_answer
+// Parameters: The player's answer, either 'y' or 'n'
+// Returns:    The text to show next
+// Does:       Advances in the direction of the answer to a question. If the
+//             user tells the program that its guess was incorrect, it finds
+//             the entries whose answers are closest, by hamming distance, to
+//             those of the entry that it guessed, essentially giving the
+//             player a little slack for an error or dissent of judgement,
+//             and guesses those, nearest first, for as long as there are
+//             guesses left to be made
+string gameSession::neighbors_answer(char command)
+{
+    if (phase == ASKING) {
+        if (command == 'y' or command == 'n') {
+            cursor.advance(command == 'y');
+            guesses_made++;
+        }
+        return neighbors_next();
+    } else if (command == 'y') {
+        return finish("I win!!!");
+    } else if (phase == GUESSING_NEIGHBORS) {
+        neighbor = neighbors.get_a_neighbor();
+        neighbors_given++;
+        guesses_made++;
+        return next_neighbor();
+    }
+
+    guesses_made++;
+    if (guesses_made >= 20) {
+        // That was our last guess left, so there is no need to ask the
+        // neighbors
+        return finish("");
+    }
+    neighbors = game->neighbor_index().find_nearest_of(cursor.entry_at_curr(),
+                                                       20 - guesses_made);
+    neighbor = neighbors.get_a_neighbor();
+    neighbors_given = 1;
+    return next_neighbor();
+}
+
+// Function next_neighbor
+// Parameters: None
+// Returns:    A guess of the next neighbor, or the message that the player
+//             has won once the guesses or the neighbors have run out
+string gameSession::next_neighbor()
+{
+    if (guesses_made < 20 and neighbor != "No more neighbors") {
+        phase = GUESSING_NEIGHBORS;
+        return guess(neighbor);
+    }
+    return finish("You win, I am stumped...");
+}
+
+// Function numbered
+// Parameters: A line of text
+// Returns:    The line, numbered by the guess that it is
+string gameSession::numbered(const string &line)
+{
+    return to_string(guesses_made + 1) + ". " + line + "\n";
+}
+
+// Function guess
+// Parameters: The name of an entry
+// Returns:    A numbered guess of the entry
+string gameSession::guess(const string &name)
+{
+    return numbered("Are you thinking of " + name + "?");
+}
+
+// Function finish
+// Parameters: The last line of the game, or the empty string for none
+// Returns:    That line, ended
+// Does:       Ends the game
+string gameSession::finish(const string &line)
+{
+    phase = DONE;
+    return line.empty() ? line : line + "\n";
+}
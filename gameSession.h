@@ -0,0 +1,77 @@
+// gameSession.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the gameSession class, one game of twenty questions
+//          played a step at a time. Rather than reading the player's answers
+//          itself, a gameSession is handed each answer as it arrives and
+//          returns the text to show the player next, the same text that the
+//          game has always printed. So the game on standard input and any
+//          number of games on the connections of a server are all played by
+//          the same code. A gameSession plays on the shared tree and neighbor
+//          index of the TwentyQgame that it was made from, which must outlive
+//          it. Between answers, the whole state of a game can be saved to a
+//          short string and restored into a gameSession of the same 
+//          TwentyQgame, or of one made from the same files in another 
+//          process, so that idle games can be stored anywhere and picked up
+//          by any worker
+//
+
+#include <string>
+#include "TwentyQgame.h"
+#include "KDtree.h"
+#include "hammingTrie.h"
+#include "userInput.h"
+
+using namespace std;
+
+#ifndef _GAMESESSION_H_
+#define _GAMESESSION_H_
+
+class gameSession {
+public:
+    gameSession(TwentyQgame &game);
+
+    string start();
+    string answer(const string &input);
+    string answer(userInput input);
+
+    string save();
+    bool restore(const string &state);
+
+    bool finished() const;
+    bool reads_words() const;
+    int question_asked();
+    string guess_made();
+
+private:
+    // What the text that was last returned asked the player for
+    enum Phase { WELCOME, ASKING, GUESSING, GUESSING_NEIGHBORS, DONE };
+
+    TwentyQgame *game;
+    KDtree::GameCursor cursor;
+    hammingTrie::Cursor neighbors;
+    string neighbor;
+    Phase phase;
+    int guesses_made;
+    // The number of neighbors taken from the neighbors cursor so far
+    int neighbors_given;
+
+    void restore_neighbors();
+
+    string begin_prompt();
+    string welcome_answer(char command);
+
+    string proto_next();
+    string proto_answer(char command);
+    string prob_next();
+    string prob_answer(const string &command);
+    string neighbors_next();
+    string neighbors_answer(char command);
+    string next_neighbor();
+
+    string numbered(const string &line);
+    string guess(const string &name);
+    string finish(const string &line);
+};
+
+#endif
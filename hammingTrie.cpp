@@ -6,248 +6,231 @@
 
 #include <iostream>
 #include <vector>
+#include <cstring>
+#include <algorithm>
 #include "questions_and_entries.h"
-#include "Stack.h"
+#include "answerMatrix.h"
+#include "dataset.h"
+#include "multiIndexHash.h"
+#include "radixTrie.h"
 #include "hammingTrie.h"
 
 using namespace std;
 
 // Constructor hammingTrie
-// Does: Initializies an instance of the hammingTrie class, by creating a root
-//       node whose name is "root" and next pointers are both set to nullptr
-hammingTrie::hammingTrie(vector<Entry> &entries)
+// Does: Initializies an instance of the hammingTrie class, by indexing the 
+//       codes of the entries with a multiIndexHash, or with a radixTrie if 
+//       it is to be compressed. The answers of every entry are read as 
+//       packed bits from the dataset's answerMatrix, which the index points
+//       into for as long as the hammingTrie keeps the dataset
+hammingTrie::hammingTrie(shared_ptr<const dataset> data, bool compressed)
 {
-    entriesVec = entries;
-
-    root = new Node;
-    root->name = "root";
-    root->one = nullptr;
-    root->zero = nullptr;
-    build_trie();
+    this->data = data;
+    const answerMatrix &answers = data->answers();
+
+    index = nullptr;
+    radix = nullptr;
+    if (compressed) {
+        radix = new radixTrie(answers.row(0), answers.words_per_row(),
+                              answers.num_questions(), distinct_codes());
+    } else {
+        index = new multiIndexHash(answers.row(0), answers.words_per_row(),
+                                   answers.num_questions(), 
+                                   distinct_codes());
+    }
 }
 
 // Destructor hammingTrie
 // Does: Frees memory that was used to store the hammingTrie
 hammingTrie::~hammingTrie()
 {
-    root = post_order_delete(root);
-}
-
-// Function post_order_delete
-// Parameters: A pointer to a Node, node, which we wish to delete
-// Returns:    The nullptr
-// Does:       Checks to see if the given node is nullptr. If it isn't,
-//             it recursively calls itself on both of node's children then 
-//             deletes node
-hammingTrie::Node *hammingTrie::post_order_delete(Node *node)
-{
-    if (node == nullptr) {
-        return nullptr;
-    } else {
-        node->zero = post_order_delete(node->zero);
-        node->one = post_order_delete(node->one);
-        delete node;
-        return nullptr;
-    }
+    delete index;
+    delete radix;
 }
 
 // Function get_a_neighbor
 // Parameters: None
 // Returns:    A string
-// Does:       Gets a string from the neighbors stack. If the neighbors stack
-//             is empty, returns the string "no more neighbors"
-string hammingTrie::get_a_neighbor()
+// Does:       Gets the name of the next neighbor that the search found. If 
+//             every neighbor has been handed out, returns the string 
+//             "No more neighbors"
+string hammingTrie::Cursor::get_a_neighbor()
 {
-    if (not neighbors.is_empty()) {
-        string to_return = neighbors.top();
-        neighbors.pop();
-        return to_return;
+    if (next < neighbor_ids.size()) {
+        return trie->data->entry_name(neighbor_ids[next++]);
     } else {
         return "No more neighbors";
     }
 }
 
-// Function make_node
+// Function make_cursor
 // Parameters: None
-// Returns:    A pointer to a Node, space for which has been newly allocated on
-//             the heap
-// Does:       Allocates space for a Node struct, sets its name to the string
-//             " " and sets both of its next pointers to the nullptr
-hammingTrie::Node *hammingTrie::make_node()
+// Returns:    An empty Cursor over this hammingTrie's entries
+hammingTrie::Cursor hammingTrie::make_cursor() const
 {
-    Node *one_node = new Node;
-    one_node->name = " ";
-    one_node->zero = nullptr;
-    one_node->one = nullptr;
-    return one_node;
+    Cursor cursor;
+    cursor.trie = this;
+    cursor.next = 0;
+    return cursor;
 }
 
-// Function build_trie
+// Function distinct_codes
 // Parameters: None
-// Returns:    None
-// Does:       Iterates through each of the entries points, and adds those
-//             points to the trie.
-void hammingTrie::build_trie()
+// Returns:    The indices of the entries to index, one for each code
+// Does:       Sorts the entries by their codes, keeping entries with the same
+//             code in their original order, and keeps the last entry of each
+//             run of equal codes
+vector<int32_t> hammingTrie::distinct_codes()
 {
-    for (size_t i = 0; i < entriesVec.size(); i++) {
-        add_point(entriesVec[i].answers, entriesVec[i].name); 
+    const answerMatrix &answers = data->answers();
+    size_t row_bytes = answers.words_per_row() * sizeof(uint64_t);
+    vector<int32_t> order(data->num_entries());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<int32_t>(i);
     }
-}
-
-// Function add_point
-// Parameters: A vector of integers (which is the binary sequence that defines 
-//             a data point, and a string, point_name which is the name of that
-//             entry)
-// Returns:    None
-// Does:       Adds a point to the trie by tracing along the nodes until it 
-//             finds a nullptr where it needs a new branch to accomodate this 
-//             new point. When this happens, it will call the make_node 
-//             function before advancing to that node. Ends by setting the 
-//             final node's name to the point_name which will overwrite that 
-//             point's name if the new point's answer sequence is a duplicate 
-//             of one already in the trie
-void hammingTrie::add_point(vector<int> answers, string point_name) 
-{
-    Node *curr = root;
-
-    for (size_t i = 0; i < answers.size(); i++) {
-        if (answers[i] == 0) {
-            if (curr->zero == nullptr) {
-                curr->zero = make_node();
-            }
-            curr = curr->zero;
-        } else {
-            if (curr->one == nullptr) {
-                curr->one = make_node();
-            }
-            curr = curr->one;
+    stable_sort(order.begin(), order.end(), 
+                [&answers, row_bytes](int32_t a, int32_t b) {
+        return memcmp(answers.row(a), answers.row(b), row_bytes) < 0;
+    });
+
+    vector<int32_t> distinct;
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i + 1 == order.size() or 
+            memcmp(answers.row(order[i]), answers.row(order[i + 1]), 
+                   row_bytes) != 0) {
+            distinct.push_back(order[i]);
         }
     }
-
-    curr->name = point_name;
+    return distinct;
 }
 
 // Function find_neighbors_of 
 // Parameters: A string, point_name, the name of an entry whose neighbors we 
-//             want to add to the neighbors stack
-// Returns:    None
-// Does:       Uses a for loop to find the binary answers sequence of the given
-//             name, then calls adds its second degree neighbors followed by 
-//             the first degree neighbors to the neighbors stack
-void hammingTrie::find_neighbors_of(string point_name) 
+//             want to find, and the radius to search
+// Returns:    A Cursor over the neighbors
+// Does:       Looks the name up in the dataset's index of names, then adds
+//             the neighbors of the entry with that name to the Cursor. If 
+//             more than one entry has the name, the neighbors of the last of
+//             them come first
+hammingTrie::Cursor hammingTrie::find_neighbors_of(const string &point_name, 
+                                                   int radius) const
 {
-    for (size_t i = 0; i < entriesVec.size(); i++) {
-        if (entriesVec[i].name == point_name) {
-            // find neighbors of that point
-            find_second_degree_of(entriesVec[i].answers);
-            find_first_degree_of(entriesVec[i].answers);
-        }
+    Cursor cursor = make_cursor();
+    vector<multiIndexHash::Match> matches;
+    vector<int32_t> ids;
+    data->find_entries(point_name, ids);
+    for (size_t i = ids.size(); i > 0; i--) {
+        within(ids[i - 1], radius, matches);
+        add_matches(matches, matches.size(), cursor);
     }
+    return cursor;
 }
 
 // Function find_neighbors_of
-// Parameters: An integer, the index of an entry
-// Returns:    None
+// Parameters: An integer, the index of an entry, and the radius to search
+// Returns:    A Cursor over the neighbors
 // Does:       Overloaded version of find_neighbors_of where we are given the 
-//             index of the entry whose neighbors we want to add to the stack.
-//             here we don't have to search through the entry's vector in order
-//             to find the matching answers vector of the given string, we have
-//             random access to that entry
-void hammingTrie::find_neighbors_of(int entry_index)
+//             index of the entry whose neighbors we want to find. Every entry
+//             whose code differs from the entry's in at least one and at most
+//             radius answers is found, the closest of them first
+hammingTrie::Cursor hammingTrie::find_neighbors_of(int entry_index, 
+                                                   int radius) const
 {
-    find_second_degree_of(entriesVec[entry_index].answers);
-    find_first_degree_of(entriesVec[entry_index].answers);
+    Cursor cursor = make_cursor();
+    vector<multiIndexHash::Match> matches;
+    within(entry_index, radius, matches);
+    add_matches(matches, matches.size(), cursor);
+    return cursor;
 }
 
-// Function find_second_degree_of
-// Parameters: A vector of integers, answers, the binary sequence from which
-//             we want to find sequences with a hamming distance of two.
-// Returns:    None
-// Does:       Uses for-loops to produce sequences that have a hamming distance
-//             of two, then searches the trie for those neighbors adding them
-//             to the neighbors stack if they are found. Essentially we want to
-//             check binary sequences that differ from the given at two of the 
-//             elements. 
-void hammingTrie::find_second_degree_of(vector<int> answers)
+// Function find_nearest_of
+// Parameters: A string, point_name, the name of an entry whose neighbors we
+//             want to find, and how many to find
+// Returns:    A Cursor over the neighbors
+// Does:       Looks the name up in the dataset's index of names, then adds
+//             the k nearest neighbors of the entry with that name to the 
+//             Cursor. If more than one entry has the name, the neighbors of 
+//             the last of them come first
+hammingTrie::Cursor hammingTrie::find_nearest_of(const string &point_name, 
+                                                 size_t k) const
 {
-    for (int i = 0; i < static_cast<int>(answers.size()) - 1; i++) {
-        answers[i] = switch_value(answers[i]);
-
-        for (int j = i + 1; j < static_cast<int>(answers.size()); j++) {
-            answers[j] = switch_value(answers[j]);
-            // This combination of for-loops will change two of the elements in
-            // the sequence in every way possible
-
-            string name_in_trie = neighbor_name(answers);
-            if (name_in_trie != " ") {
-                neighbors.push(name_in_trie);
-            } 
-
-            answers[j] = switch_value(answers[j]);
-        }
-        answers[i] = switch_value(answers[i]);
-        // We switch the elements in the sequence back to their original values
-        // once finished so that we can check the next neighbor
+    Cursor cursor = make_cursor();
+    vector<multiIndexHash::Match> matches;
+    vector<int32_t> ids;
+    data->find_entries(point_name, ids);
+    for (size_t i = ids.size(); i > 0; i--) {
+        // One more than k, since the entry's own code is the nearest
+        nearest(ids[i - 1], k + 1, matches);
+        add_matches(matches, k, cursor);
     }
+    return cursor;
 }
 
-// Function find_first_degree_of
-// Parameters: A vector of integers, answers, the binary sequence that
-//             corresponds to a certain data point in the trie
+// Function find_nearest_of
+// Parameters: An integer, the index of an entry, and how many neighbors to 
+//             find
+// Returns:    A Cursor over the neighbors
+// Does:       Finds the k entries whose codes are nearest to the entry's, 
+//             however far away they are, other than the entry itself, the 
+//             closest of them first
+hammingTrie::Cursor hammingTrie::find_nearest_of(int entry_index, 
+                                                 size_t k) const
+{
+    Cursor cursor = make_cursor();
+    vector<multiIndexHash::Match> matches;
+    // One more than k, since the entry's own code is the nearest of all
+    nearest(entry_index, k + 1, matches);
+    add_matches(matches, k, cursor);
+    return cursor;
+}
+
+// Function within
+// Parameters: The index of an entry, a radius, and a vector of Matches, 
+//             passed by reference
 // Returns:    None
-// Does:       Checks the trie for sequences that differ from the given answers
-//             sequence at a single element (hamming distance of one). If one
-//             or more are found, they are added to the neighbors stack to be
-//             guessed
-void hammingTrie::find_first_degree_of(vector<int> answers) 
+// Does:       Sets matches to every code within the radius of the entry's, 
+//             nearest first, from whichever index was made
+void hammingTrie::within(int entry_index, int radius, 
+                         vector<multiIndexHash::Match> &matches) const
 {
-    for (size_t i = 0; i < answers.size(); i++) {
-        answers[i] = switch_value(answers[i]);
-        string name_in_trie = neighbor_name(answers);
-        if (name_in_trie != " " ) {
-            neighbors.push(name_in_trie);
-        }
-        answers[i] = switch_value(answers[i]);
+    if (radix != nullptr) {
+        radix->within(data->answers().row(entry_index), radius, matches);
+    } else {
+        index->within(data->answers().row(entry_index), radius, matches);
     }
 }
 
-// Function neighbor_name
-// Parameters: A vector of integers- 0s and 1s
-// Returns:    A string, could be the empty string if the binary string is not
-//             present in the trie or the stored entry name if the string is in
-//             the trie
-// Does:       Traverses the trie in accordance with the given binary sequence
-//             in order to determine if a neighbor exists in the tree. If it 
-//             does, we return the neighbor's name as string. If not we return
-//             the single-space string " ".
-string hammingTrie::neighbor_name(vector<int> answers)
+// Function nearest
+// Parameters: The index of an entry, the number of codes to find, k, and a 
+//             vector of Matches, passed by reference
+// Returns:    None
+// Does:       Sets matches to the k codes nearest to the entry's, nearest 
+//             first, from whichever index was made
+void hammingTrie::nearest(int entry_index, size_t k, 
+                          vector<multiIndexHash::Match> &matches) const
 {
-    Node *curr = root;
-    if (curr == nullptr) {
-        return " ";
-    }
-    
-    for (size_t i = 0; i < answers.size(); i++) {
-        if (answers[i] == 0) {
-            curr = curr->zero;
-        } else {
-            curr = curr->one;
-        }
-        if (curr == nullptr) {
-            return " ";
-        }
+    if (radix != nullptr) {
+        radix->nearest(data->answers().row(entry_index), k, matches);
+    } else {
+        index->nearest(data->answers().row(entry_index), k, matches);
     }
-
-    return curr->name;
 }
 
-// Function switch_value
-// Parameters: An integer x, which will be the binary value 1 or 0
-// Returns:    An integer, either 1 or 0
-// Does:       If the given entry is odd (1), returns 0, if the given entry is
-//             even (0), returns 1
-int hammingTrie::switch_value(int x) 
+// Function add_matches
+// Parameters: A vector of Matches, passed by reference, nearest first, the 
+//             most of them to add, and the Cursor to add them to
+// Returns:    None
+// Does:       Adds up to limit matches that are at least one answer away to 
+//             the end of the Cursor, nearest first
+void hammingTrie::add_matches(vector<multiIndexHash::Match> &matches, 
+                              size_t limit, Cursor &cursor) const
 {
-    return (x + 1) % 2;
+    size_t first = 0;
+    while (first < matches.size() and matches[first].distance == 0) {
+        first++;
+    }
+    size_t last = min(matches.size(), first + limit);
+    for (size_t i = first; i < last; i++) {
+        cursor.neighbor_ids.push_back(matches[i].id);
+    }
 }
-
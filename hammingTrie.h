@@ -1,19 +1,31 @@
 // hammingTrie.h
 // By: Miles Izydorczak
 // Date: 3 December 2019
-// Purpose: Trie of the binary answers to each question of each answer. Used to
-//          determine K nearest neighbors of an entry: if we guess an entry and
-//          the player says that is not what they were thinking of, we 
-//          determine all other entries that have a hamming distance of one 
-//          from that tree, to ask other entries that are similar enough to the
-//          entry that they guessed such that there is only a single question
-//          that separates the two entries
+// Purpose: Index of the binary answers to each question of each answer. Used
+//          to determine K nearest neighbors of an entry: if we guess an entry
+//          and the player says that is not what they were thinking of, we 
+//          determine the other entries whose answers are closest to those of
+//          the entry that they guessed, by hamming distance, to ask other 
+//          entries that are similar enough to the entry that they guessed 
+//          such that only a question or two separates the two entries. The 
+//          answer codes are searched with a multiIndexHash, or with the much
+//          smaller but slower radixTrie when memory is short, so the 
+//          neighbors can be any distance away. Entries that share a code are
+//          kept once, as the last of them. A hammingTrie is never changed
+//          once it is built, so one of them can be shared by every game in
+//          the process: each search returns its own Cursor over the
+//          neighbors it found, and any number of searches may run at once
 //
 
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <stdint.h>
 #include "questions_and_entries.h"
-#include "Stack.h"
+#include "answerMatrix.h"
+#include "dataset.h"
+#include "multiIndexHash.h"
+#include "radixTrie.h"
 
 using namespace std;
 
@@ -23,43 +35,47 @@ using namespace std;
 class hammingTrie {
 public:
 
-    hammingTrie(vector<Entry> &entries);
+    // The neighbors found by one search, handed out nearest first
+    class Cursor {
+    public:
+        string get_a_neighbor();
+        size_t size() const { return neighbor_ids.size(); }
 
-    ~hammingTrie();
-
-    void find_neighbors_of(string point_name);
-    void find_neighbors_of(int entry_index);
-
-    string get_a_neighbor();
-
-
-
-private:
-
-    vector<Entry> entriesVec;
+    private:
+        friend class hammingTrie;
 
-    struct Node {
-        string name;
-        Node *one;
-        Node *zero;
+        const hammingTrie *trie;
+        vector<int32_t> neighbor_ids;
+        size_t next;
     };
 
-    Node *root;
-
-    Node *make_node();
+    hammingTrie(shared_ptr<const dataset> data, bool compressed);
 
-    Node *post_order_delete(Node *node);
-
-    void add_point(vector<int> answers, string point_name);
-    void build_trie();
-    void find_second_degree_of(vector<int> answers);
-    void find_first_degree_of(vector<int> answers);
-    int switch_value(int x);
-    string neighbor_name(vector<int> answers);
+    ~hammingTrie();
 
-    Stack<string> neighbors;
+    Cursor find_neighbors_of(const string &point_name, int radius) const;
+    Cursor find_neighbors_of(int entry_index, int radius) const;
+    Cursor find_nearest_of(const string &point_name, size_t k) const;
+    Cursor find_nearest_of(int entry_index, size_t k) const;
 
+private:
 
+    // The entries and answers that are searched, shared with the game
+    shared_ptr<const dataset> data;
+
+    // Exactly one of the two is made, the radixTrie if the hammingTrie is
+    // compressed
+    multiIndexHash *index;
+    radixTrie *radix;
+
+    vector<int32_t> distinct_codes();
+    Cursor make_cursor() const;
+    void within(int entry_index, int radius, 
+                vector<multiIndexHash::Match> &matches) const;
+    void nearest(int entry_index, size_t k, 
+                 vector<multiIndexHash::Match> &matches) const;
+    void add_matches(vector<multiIndexHash::Match> &matches, size_t limit,
+                     Cursor &cursor) const;
 };
 
 #endif
@@ -2,24 +2,245 @@
 // By: Miles Izydorczak
 // Date: 18 November 2019
 // Purpose: Main function for the 20 questions game. Reads in command line
-//          arguments and uses them to create an instance of the TwentyQgame 
-//          class, then runs the game. 
+//          arguments and uses them to create an instance of the TwentyQgame
+//          class, then runs the game.
 //
 
 #include <iostream>
+#include <cstdlib>
+#include <climits>
+#include <string>
 #include "TwentyQgame.h"
+#include "options.h"
+#include "catalogGenerator.h"
+#include "runStats.h"
 
 using namespace std;
 
+const string USAGE = "Usage: ./20Q [--threads N] [--parallel-cutoff N] "
+                     "[--lazy] [--seed N] [--sample-size N] "
+                     "[--sample-tolerance X] [--radix-neighbors] "
+                     "[--noise X] [--stats text|json]\n"
+                     "       [--compile treeFile | --serve address | "
+                     "--simulate] version entriesFile questionsFile\n"
+                     "       ./20Q [options] --dataset datasetFile version\n"
+                     "       ./20Q --convert datasetFile entriesFile "
+                     "questionsFile\n"
+                     "       ./20Q [--serve address | --simulate [--noise X]] "
+                     "--tree treeFile\n"
+                     "       ./20Q [--threads N] [--seed N] [--yes-rate X] "
+                     "[--yes-spread X] [--clusters N]\n"
+                     "             [--correlation X] [--duplicates X] "
+                     "--generate numEntries numQuestions\n"
+                     "             (entriesFile questionsFile | datasetFile)"
+                     "\n"
+                     "An address to serve on is a TCP port of localhost, or "
+                     "the path of a Unix-domain socket. --simulate plays a "
+                     "game for every entry\nand --noise is the share of "
+                     "its answers that are wrong or unsure. --stats prints "
+                     "what the run did and how long it took\nto standard "
+                     "error as it exits";
+
+// Function read_count
+// Parameters: The name of an option, the string that was given as its value,
+//             and the smallest value that the option allows
+// Returns:    The value as an integer
+// Does:       Converts the value, printing the usage and exiting if it is not
+//             an integer of at least the minimum
+long read_count(string option, string value, long minimum = 1)
+{
+    char *end;
+    long count = strtol(value.c_str(), &end, 10);
+    if (value.empty() or *end != '\0' or count < minimum) {
+        cerr << "Invalid value for " << option << ": " << value << endl
+             << USAGE << endl;
+        exit(1);
+    }
+    return count;
+}
+
+// Function read_fraction
+// Parameters: The name of an option and the string that was given as its 
+//             value
+// Returns:    The value as a double
+// Does:       Converts the value, printing the usage and exiting if it is not
+//             a number from 0 up to but not including 1
+double read_fraction(string option, string value)
+{
+    char *end;
+    double fraction = strtod(value.c_str(), &end);
+    if (value.empty() or *end != '\0' or not (fraction >= 0 and 
+                                              fraction < 1)) {
+        cerr << "Invalid value for " << option << ": " << value << endl
+             << USAGE << endl;
+        exit(1);
+    }
+    return fraction;
+}
+
 int main(int argc, char *argv[])
 {
-    if (argc != 4) {
-        cerr << "Usage: ./20Q version entriesFile questionsFile" << endl;
+    BuildOptions options;
+    string compile_file, tree_file, dataset_file, convert_file, serve_address;
+    bool simulate = false;
+    double noise = 0;
+    bool generate = false;
+    GeneratorOptions generator;
+    int arg = 1;
+    while (arg < argc and string(argv[arg]).compare(0, 2, "--") == 0) {
+        string option = argv[arg];
+        // The options that take no value
+        if (option == "--lazy") {
+            options.lazy = true;
+            arg++;
+            continue;
+        } else if (option == "--radix-neighbors") {
+            options.radix_neighbors = true;
+            arg++;
+            continue;
+        } else if (option == "--simulate") {
+            simulate = true;
+            arg++;
+            continue;
+        } else if (option == "--generate") {
+            generate = true;
+            arg++;
+            break;
+        }
+        if (arg + 1 >= argc) {
+            cerr << USAGE << endl;
+            exit(1);
+        }
+        if (option == "--threads") {
+            options.threads = read_count(option, argv[arg + 1]);
+        } else if (option == "--parallel-cutoff") {
+            options.parallel_cutoff = read_count(option, argv[arg + 1]);
+        } else if (option == "--seed") {
+            options.seed = read_count(option, argv[arg + 1], 0);
+        } else if (option == "--sample-size") {
+            options.sample_size = read_count(option, argv[arg + 1]);
+        } else if (option == "--sample-tolerance") {
+            options.sample_tolerance = read_fraction(option, argv[arg + 1]);
+        } else if (option == "--compile") {
+            compile_file = argv[arg + 1];
+        } else if (option == "--tree") {
+            tree_file = argv[arg + 1];
+        } else if (option == "--dataset") {
+            dataset_file = argv[arg + 1];
+        } else if (option == "--convert") {
+            convert_file = argv[arg + 1];
+        } else if (option == "--serve") {
+            serve_address = argv[arg + 1];
+        } else if (option == "--noise") {
+            noise = read_fraction(option, argv[arg + 1]);
+        } else if (option == "--yes-rate") {
+            generator.yes_rate = read_fraction(option, argv[arg + 1]);
+        } else if (option == "--yes-spread") {
+            generator.yes_spread = read_fraction(option, argv[arg + 1]);
+        } else if (option == "--clusters") {
+            generator.clusters = read_count(option, argv[arg + 1], 0);
+        } else if (option == "--correlation") {
+            generator.correlation = read_fraction(option, argv[arg + 1]);
+        } else if (option == "--duplicates") {
+            generator.duplicates = read_fraction(option, argv[arg + 1]);
+        } else if (option == "--stats") {
+            string format = argv[arg + 1];
+            if (format != "text" and format != "json") {
+                cerr << "Invalid value for " << option << ": " << format
+                     << endl << USAGE << endl;
+                exit(1);
+            }
+            runStats::report_at_exit(format == "json");
+        } else {
+            cerr << "Unknown option: " << option << endl << USAGE << endl;
+            exit(1);
+        }
+        arg += 2;
+    }
+
+    // A made up catalog is written as text files or as a dataset file. Its
+    // entries are numbered by ints, so there can be at most INT_MAX of them
+    if (generate) {
+        if (argc - arg != 3 and argc - arg != 4) {
+            cerr << USAGE << endl;
+            exit(1);
+        }
+        generator.num_entries = read_count("numEntries", argv[arg], 1);
+        generator.num_questions = read_count("numQuestions", argv[arg + 1],
+                                             1);
+        if (generator.num_entries > INT_MAX) {
+            cerr << "Invalid value for numEntries: " << argv[arg] << endl
+                 << USAGE << endl;
+            exit(1);
+        }
+        generator.seed = options.seed;
+        generator.threads = options.threads;
+        catalogGenerator catalog(generator);
+        if (argc - arg == 4) {
+            catalog.write_text(argv[arg + 2], argv[arg + 3]);
+        } else {
+            catalog.write_dataset(argv[arg + 2]);
+        }
+        return 0;
+    }
+
+    // At most one of compiling, serving and simulating is asked for
+    if ((not compile_file.empty()) + (not serve_address.empty()) + 
+        simulate > 1) {
+        cerr << USAGE << endl;
+        exit(1);
+    }
+
+    // A compiled tree file is played on its own, without the text files
+    if (not tree_file.empty()) {
+        if (argc - arg != 0 or not compile_file.empty()) {
+            cerr << USAGE << endl;
+            exit(1);
+        }
+        TwentyQgame game(tree_file, options);
+        if (not serve_address.empty()) {
+            game.serve(serve_address);
+        } else if (simulate) {
+            game.simulate(noise);
+        } else {
+            game.run();
+        }
+        return 0;
+    }
+
+    if (not convert_file.empty()) {
+        if (argc - arg != 2) {
+            cerr << USAGE << endl;
+            exit(1);
+        }
+        TwentyQgame::convert(argv[arg], argv[arg + 1], convert_file);
+        return 0;
+    }
+
+    // A dataset file stands in for both of the text files
+    int num_files = dataset_file.empty() ? 2 : 0;
+    if (argc - arg != 1 + num_files) {
+        cerr << USAGE << endl;
         exit(1);
-    } 
+    }
 
-    TwentyQgame game(argv[1], argv[2], argv[3]);
-    game.run();
+    TwentyQgame *game;
+    if (not dataset_file.empty()) {
+        game = new TwentyQgame(argv[arg], dataset_file, options);
+    } else {
+        game = new TwentyQgame(argv[arg], argv[arg + 1], argv[arg + 2],
+                               options);
+    }
+    if (not compile_file.empty()) {
+        game->compile(compile_file);
+    } else if (not serve_address.empty()) {
+        game->serve(serve_address);
+    } else if (simulate) {
+        game->simulate(noise);
+    } else {
+        game->run();
+    }
+    delete game;
 
     return 0;
 }
@@ -0,0 +1,147 @@
+// mappedFile.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the mappedFile class
+//
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "mappedFile.h"
+
+using namespace std;
+
+// Constructor mappedFile
+// Parameters: What kind of file it is, such as "tree file"
+// Does:       Initializes a mappedFile that has not mapped any file yet
+mappedFile::mappedFile(string kind)
+{
+    this->kind = kind;
+    data = nullptr;
+    size = 0;
+    string_offsets = nullptr;
+    strings = nullptr;
+}
+
+// Destructor ~mappedFile
+// Does: Unmaps the file, if one was mapped
+mappedFile::~mappedFile()
+{
+    if (data != nullptr) {
+        munmap(const_cast<char *>(data), size);
+    }
+}
+
+// Function map
+// Parameters: The name of the file, the magic and format number that it must
+//             begin with, and the size of its header
+// Returns:    None
+// Does:       Maps the whole file read-only into memory, then checks that it
+//             is at least as large as the header, and that its magic, byte
+//             order and format match this program. Prints an error and exits
+//             if the file cannot be used
+void mappedFile::map(string filename, const char *magic, uint32_t format,
+                     size_t header_bytes)
+{
+    this->filename = filename;
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail("could not be opened");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 or
+        static_cast<size_t>(info.st_size) < header_bytes or
+        static_cast<size_t>(info.st_size) < sizeof(Prefix)) {
+        close(fd);
+        fail("is too small to be a " + kind);
+    }
+
+    size = info.st_size;
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        size = 0;
+        fail("could not be mapped");
+    }
+    data = static_cast<const char *>(mapped);
+
+    const Prefix *prefix = reinterpret_cast<const Prefix *>(data);
+    if (memcmp(prefix->magic, magic, sizeof(prefix->magic)) != 0) {
+        fail("is not a " + kind);
+    } else if (prefix->byte_order != BYTE_ORDER_MARK) {
+        fail("was written on a machine of another byte order");
+    } else if (prefix->format != format) {
+        fail("was written by another version of this program");
+    }
+}
+
+// Function read_once
+// Parameters: None
+// Returns:    None
+// Does:       Tells the system that the file will be read from front to back
+//             exactly once, so that it reads ahead of the reader
+void mappedFile::read_once()
+{
+    madvise(const_cast<char *>(data), size, MADV_SEQUENTIAL);
+}
+
+// Function check_strings
+// Parameters: Where the string table's offsets start and how many strings
+//             there are, where the strings start and how many bytes they
+//             take up, and the size of the file that its header gives
+// Returns:    None
+// Does:       Checks that the file is as large as its header says, that the
+//             offsets lie before the strings and the strings inside the file,
+//             and that every offset lies inside the strings, none before the
+//             one before it, so that string_at never reads outside the file.
+//             Prints an error and exits if the table cannot be used
+void mappedFile::check_strings(uint64_t offsets_offset, uint64_t num_strings,
+                               uint64_t strings_offset, uint64_t strings_bytes,
+                               uint64_t file_bytes)
+{
+    if (file_bytes != size or strings_bytes > size or
+        strings_offset > size - strings_bytes) {
+        fail("is truncated");
+    } else if (offsets_offset > strings_offset or
+               (strings_offset - offsets_offset) / sizeof(uint64_t) <
+                   num_strings + 1) {
+        fail("has overlapping sections");
+    }
+
+    string_offsets = reinterpret_cast<const uint64_t *>(data +
+                                                        offsets_offset);
+    strings = data + strings_offset;
+    if (string_offsets[num_strings] != strings_bytes) {
+        fail("has a damaged string table");
+    }
+    for (uint64_t i = 0; i < num_strings; i++) {
+        if (string_offsets[i] > string_offsets[i + 1]) {
+            fail("has a damaged string table");
+        }
+    }
+}
+
+// Function string_at
+// Parameters: The index of a string in the string table
+// Returns:    A copy of that string
+string mappedFile::string_at(size_t index) const
+{
+    return string(strings + string_offsets[index],
+                  string_offsets[index + 1] - string_offsets[index]);
+}
+
+// Function fail
+// Parameters: Why the file could not be used
+// Returns:    None, it exits the program
+void mappedFile::fail(string reason)
+{
+    string name = kind;
+    name[0] = toupper(name[0]);
+    cerr << name << " " << filename << " " << reason << endl;
+    exit(1);
+}
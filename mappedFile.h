@@ -0,0 +1,62 @@
+// mappedFile.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the mappedFile class, the part that the binary
+//          formats of the game, tree files and dataset files, have in
+//          common. It maps a whole file read-only into memory and checks
+//          what every format begins with: an 8 byte magic, a byte order mark
+//          and a format number. It also checks and reads the string table
+//          that every format ends with, a vector of offsets followed by the
+//          bytes of the strings. Each format checks its own sections, and
+//          reports them through fail, so every error names the file in the
+//          same way
+//
+
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+
+using namespace std;
+
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+// Written into every file, and read back as this value only on a machine of
+// the same byte order
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+class mappedFile {
+public:
+    mappedFile(string kind);
+    ~mappedFile();
+
+    // Every format's header begins with these fields
+    struct Prefix {
+        char magic[8];
+        uint32_t byte_order;
+        uint32_t format;
+    };
+
+    void map(string filename, const char *magic, uint32_t format,
+             size_t header_bytes);
+    void read_once();
+    void check_strings(uint64_t offsets_offset, uint64_t num_strings,
+                       uint64_t strings_offset, uint64_t strings_bytes,
+                       uint64_t file_bytes);
+
+    const char *bytes() const { return data; }
+    string string_at(size_t index) const;
+
+    void fail(string reason);
+
+private:
+    // What the file is, such as "tree file", for the errors
+    string kind;
+    string filename;
+    const char *data;
+    size_t size;
+    const uint64_t *string_offsets;
+    const char *strings;
+};
+
+#endif
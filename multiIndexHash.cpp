@@ -0,0 +1,377 @@
+// multiIndexHash.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the multiIndexHash class
+//
+
+#include <algorithm>
+#include <utility>
+#include "multiIndexHash.h"
+#include "runStats.h"
+
+using namespace std;
+
+// Constructor multiIndexHash
+// Parameters: The rows of a matrix of packed codes and the number of words in
+//             each, the number of bits in a code, and the ids of the rows to
+//             index, which must stay in place for as long as the
+//             multiIndexHash is used
+// Does:       Picks substrings of about log2(N) bits for N codes, so that
+//             each value of a substring is held by about one code, but never
+//             more than 64 bits so that a substring fits in a word. The bits
+//             are shared out as evenly as they can be, the first substrings
+//             taking one extra bit each when they do not divide evenly. Then
+//             builds the table of each substring
+multiIndexHash::multiIndexHash(const uint64_t *rows, size_t row_words,
+                               size_t num_bits, const vector<int32_t> &ids)
+{
+    this->rows = rows;
+    this->row_words = row_words;
+    this->num_bits = num_bits;
+    this->ids = ids;
+
+    size_t target_length = 1;
+    while (target_length < 64 and
+           (static_cast<size_t>(1) << target_length) < ids.size()) {
+        target_length++;
+    }
+    size_t num_substrings = (num_bits + target_length - 1) / target_length;
+    size_t first_bit = 0;
+    for (size_t s = 0; s < num_substrings; s++) {
+        Substring substring;
+        substring.first_bit = first_bit;
+        substring.length = num_bits / num_substrings +
+                           (s < num_bits % num_substrings ? 1 : 0);
+        substrings.push_back(substring);
+        first_bit += substring.length;
+    }
+
+    tables.resize(num_substrings);
+    for (size_t s = 0; s < num_substrings; s++) {
+        build_table(s);
+    }
+}
+
+// Function build_table
+// Parameters: The index of a substring
+// Returns:    None
+// Does:       Sorts the codes by the value of their substring, so that the
+//             codes that share a value sit next to each other in the table's
+//             members, then puts a Bucket for each value into an open-
+//             addressed table with at least twice as many buckets as values
+void multiIndexHash::build_table(size_t s)
+{
+    vector<pair<uint64_t, int32_t> > keyed(ids.size());
+    for (size_t k = 0; k < ids.size(); k++) {
+        keyed[k].first = substring_of(rows + ids[k] * row_words, s);
+        keyed[k].second = static_cast<int32_t>(k);
+    }
+    sort(keyed.begin(), keyed.end());
+
+    size_t num_keys = 0;
+    for (size_t k = 0; k < keyed.size(); k++) {
+        if (k == 0 or keyed[k].first != keyed[k - 1].first) {
+            num_keys++;
+        }
+    }
+    size_t num_buckets = 16;
+    while (num_buckets < 2 * num_keys) {
+        num_buckets *= 2;
+    }
+
+    Table &table = tables[s];
+    Bucket empty = { 0, 0, 0 };
+    table.buckets.assign(num_buckets, empty);
+    table.mask = num_buckets - 1;
+    table.members.resize(keyed.size());
+
+    size_t begin = 0;
+    for (size_t k = 0; k < keyed.size(); k++) {
+        table.members[k] = keyed[k].second;
+        if (k + 1 == keyed.size() or keyed[k + 1].first != keyed[k].first) {
+            uint64_t key = keyed[k].first;
+            size_t b = (key * 0x9E3779B97F4A7C15ULL) >> 32 & table.mask;
+            while (table.buckets[b].begin != table.buckets[b].end) {
+                b = (b + 1) & table.mask;
+            }
+            table.buckets[b].key = key;
+            table.buckets[b].begin = static_cast<uint32_t>(begin);
+            table.buckets[b].end = static_cast<uint32_t>(k + 1);
+            begin = k + 1;
+        }
+    }
+}
+
+// Function substring_of
+// Parameters: A pointer to the packed words of a code, and the index of a
+//             substring
+// Returns:    The bits of that substring, the first of them in the lowest bit
+//             of the result
+uint64_t multiIndexHash::substring_of(const uint64_t *code, size_t s) const
+{
+    size_t first_bit = substrings[s].first_bit;
+    size_t length = substrings[s].length;
+    size_t word = first_bit >> 6, shift = first_bit & 63;
+
+    uint64_t value = code[word] >> shift;
+    if (shift != 0 and shift + length > 64) {
+        value |= code[word + 1] << (64 - shift);
+    }
+    if (length < 64) {
+        value &= (static_cast<uint64_t>(1) << length) - 1;
+    }
+    return value;
+}
+
+// Function distance_to
+// Parameters: A pointer to the packed words of a query, and the id of a code
+// Returns:    The number of bits in which the two differ
+int multiIndexHash::distance_to(const uint64_t *query, int32_t id) const
+{
+    const uint64_t *code = rows + id * row_words;
+    int distance = 0;
+    for (size_t w = 0; w < row_words; w++) {
+        distance += __builtin_popcountll(code[w] ^ query[w]);
+    }
+    return distance;
+}
+
+// Function find_bucket
+// Parameters: A Table, passed by reference, and a value of its substring
+// Returns:    A pointer to the Bucket of that value, or nullptr if no code
+//             has that value
+const multiIndexHash::Bucket *multiIndexHash::find_bucket(const Table &table,
+                                                          uint64_t key) const
+{
+    size_t b = (key * 0x9E3779B97F4A7C15ULL) >> 32 & table.mask;
+    while (table.buckets[b].begin != table.buckets[b].end) {
+        if (table.buckets[b].key == key) {
+            return &table.buckets[b];
+        }
+        b = (b + 1) & table.mask;
+    }
+    return nullptr;
+}
+
+// Function lookups_at
+// Parameters: A radius
+// Returns:    The number of lookups that it takes to try every value of every
+//             substring that is exactly that many bits away from the query's,
+//             as a double since it can be very large
+double multiIndexHash::lookups_at(int radius) const
+{
+    double lookups = 0;
+    for (size_t s = 0; s < substrings.size(); s++) {
+        double combinations = 1;
+        size_t length = substrings[s].length;
+        if (static_cast<size_t>(radius) > length) {
+            continue;
+        }
+        for (int i = 0; i < radius; i++) {
+            combinations = combinations * (length - i) / (i + 1);
+        }
+        lookups += combinations;
+    }
+    return lookups;
+}
+
+// Function start_search
+// Parameters: A pointer to the packed words of a query, and a Search, passed
+//             by reference
+// Returns:    None
+// Does:       Sets the Search up for the query, with no codes checked yet
+void multiIndexHash::start_search(const uint64_t *query, Search &search) const
+{
+    search.query = query;
+    search.seen.assign(ids.size(), false);
+    search.found.clear();
+    search.at_distance.assign(num_bits + 1, 0);
+    search.lookups = 0;
+}
+
+// Function check
+// Parameters: The position of a code in ids, and a Search, passed by
+//             reference
+// Returns:    None
+// Does:       Works out the distance from the code to the query and adds it
+//             to what has been found, unless the code was checked already
+void multiIndexHash::check(int32_t k, Search &search) const
+{
+    if (search.seen[k]) {
+        return;
+    }
+    search.seen[k] = true;
+    Match match;
+    match.id = ids[k];
+    match.distance = distance_to(search.query, ids[k]);
+    search.found.push_back(match);
+    search.at_distance[match.distance]++;
+}
+
+// Function search_variants
+// Parameters: The index of a substring, a value of it, the lowest bit that
+//             may still be switched, the number of bits left to switch, and a
+//             Search, passed by reference
+// Returns:    None
+// Does:       Recursively switches flips_left more bits of the value, each
+//             above the last one switched, so that every value that differs
+//             from the one given in exactly flips_left bits at or above
+//             from_bit is visited once. Every code in the bucket of a visited
+//             value is checked
+void multiIndexHash::search_variants(size_t s, uint64_t key, size_t from_bit,
+                                     int flips_left, Search &search) const
+{
+    if (flips_left == 0) {
+        search.lookups++;
+        const Bucket *bucket = find_bucket(tables[s], key);
+        if (bucket != nullptr) {
+            for (uint32_t i = bucket->begin; i < bucket->end; i++) {
+                check(tables[s].members[i], search);
+            }
+        }
+        return;
+    }
+    size_t length = substrings[s].length;
+    for (size_t bit = from_bit; bit + flips_left <= length; bit++) {
+        search_variants(s, key ^ (static_cast<uint64_t>(1) << bit), bit + 1,
+                        flips_left - 1, search);
+    }
+}
+
+// Function check_all
+// Parameters: A Search, passed by reference
+// Returns:    None
+// Does:       Checks every code that has not been checked yet
+void multiIndexHash::check_all(Search &search) const
+{
+    for (size_t k = 0; k < ids.size(); k++) {
+        check(static_cast<int32_t>(k), search);
+    }
+}
+
+// Function within
+// Parameters: A pointer to the packed words of a query, a radius, and a
+//             vector of Matches, passed by reference
+// Returns:    None
+// Does:       Sets matches to every code within the radius of the query, in
+//             order. Looks up every value of every substring that is no more
+//             than radius / m bits away from the query's, unless that would
+//             take more lookups than there are codes to check
+void multiIndexHash::within(const uint64_t *query, int radius,
+                            vector<Match> &matches) const
+{
+    Search search;
+    start_search(query, search);
+    matches.clear();
+    if (radius < 0) {
+        return;
+    }
+
+    int substring_radius = substrings.empty() ? 0
+                         : radius / static_cast<int>(substrings.size());
+    double lookups = 0;
+    for (int r = 0; r <= substring_radius; r++) {
+        lookups += lookups_at(r);
+    }
+    if (substrings.empty() or lookups >= ids.size()) {
+        check_all(search);
+    } else {
+        for (size_t s = 0; s < substrings.size(); s++) {
+            for (int r = 0; r <= substring_radius; r++) {
+                search_variants(s, substring_of(query, s), 0, r, search);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < search.found.size(); i++) {
+        if (search.found[i].distance <= radius) {
+            matches.push_back(search.found[i]);
+        }
+    }
+    runStats::add(runStats::TRIE_PROBES,
+                  search.lookups + search.found.size());
+    sort_matches(rows, row_words, query, matches);
+}
+
+// Function nearest
+// Parameters: A pointer to the packed words of a query, the number of codes
+//             to find, k, and a vector of Matches, passed by reference
+// Returns:    None
+// Does:       Sets matches to the k codes nearest to the query, in order, or
+//             to every code if there are no more than k of them. The radius
+//             that the substrings are searched to grows one bit at a time,
+//             one substring at a time. Once substrings [0, s] have been
+//             searched to radius r and the rest to radius r - 1, every code
+//             within m * r + s of the query has been found, since any code
+//             that has not been found differs from the query in more bits
+//             than that. The search stops as soon as k codes lie within that
+//             bound, or checks every code once the next radius would take
+//             more lookups than there are codes
+void multiIndexHash::nearest(const uint64_t *query, size_t k,
+                             vector<Match> &matches) const
+{
+    Search search;
+    start_search(query, search);
+    matches.clear();
+    if (k == 0) {
+        return;
+    }
+
+    bool done = false;
+    size_t m = substrings.size();
+    for (int r = 0; not done; r++) {
+        if (k >= ids.size() or m == 0 or lookups_at(r) >= ids.size() or
+            lookups_at(r) == 0) {
+            check_all(search);
+            break;
+        }
+        for (size_t s = 0; s < m and not done; s++) {
+            search_variants(s, substring_of(query, s), 0, r, search);
+
+            size_t bound = m * r + s, found = 0;
+            for (size_t d = 0; d <= bound and d <= num_bits; d++) {
+                found += search.at_distance[d];
+            }
+            done = found >= k;
+        }
+    }
+
+    matches = search.found;
+    runStats::add(runStats::TRIE_PROBES,
+                  search.lookups + search.found.size());
+    sort_matches(rows, row_words, query, matches);
+    if (matches.size() > k) {
+        matches.resize(k);
+    }
+}
+
+// Function sort_matches
+// Parameters: The rows of a matrix of packed codes and the number of words in
+//             each, a pointer to the packed words of a query, and a vector of
+//             Matches into the rows, passed by reference
+// Returns:    None
+// Does:       Sorts the matches nearest first. Of two codes at the same
+//             distance, the one that agrees with the query on the lowest bit
+//             where the codes disagree with each other comes first, and codes
+//             that are the same come in the order of their ids
+void multiIndexHash::sort_matches(const uint64_t *rows, size_t row_words,
+                                  const uint64_t *query,
+                                  vector<Match> &matches)
+{
+    sort(matches.begin(), matches.end(),
+         [rows, row_words, query](const Match &a, const Match &b) {
+        if (a.distance != b.distance) {
+            return a.distance < b.distance;
+        }
+        const uint64_t *code_a = rows + a.id * row_words;
+        const uint64_t *code_b = rows + b.id * row_words;
+        for (size_t w = 0; w < row_words; w++) {
+            uint64_t differ = code_a[w] ^ code_b[w];
+            if (differ != 0) {
+                uint64_t lowest = differ & (~differ + 1);
+                return ((code_a[w] ^ query[w]) & lowest) == 0;
+            }
+        }
+        return a.id < b.id;
+    });
+}
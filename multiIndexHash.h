@@ -0,0 +1,99 @@
+// multiIndexHash.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the multiIndexHash class, which answers Hamming
+//          distance queries over a set of packed binary codes: every code
+//          within some radius of a query, or the k codes nearest to it. Each
+//          code is cut into m substrings of about log2(N) bits, and each
+//          substring has its own hash table from its value to the codes that
+//          have that value. If a code is within r of the query, one of its
+//          substrings must be within r / m of the query's substring, so only
+//          the few substring values that close to the query's are looked up,
+//          and the codes found are checked against the query in full. When
+//          looking the substrings up would cost more than checking every
+//          code, every code is checked instead. Results are ordered by their
+//          distance from the query, and ties go to the code that agrees with
+//          the query on the lowest bit where the two codes disagree
+//
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+using namespace std;
+
+#ifndef _MULTIINDEXHASH_H_
+#define _MULTIINDEXHASH_H_
+
+class multiIndexHash {
+public:
+    struct Match {
+        int32_t id;
+        int32_t distance;
+    };
+
+    multiIndexHash(const uint64_t *rows, size_t row_words, size_t num_bits,
+                   const vector<int32_t> &ids);
+
+    void within(const uint64_t *query, int radius,
+                vector<Match> &matches) const;
+    void nearest(const uint64_t *query, size_t k,
+                 vector<Match> &matches) const;
+
+    size_t num_substrings() const { return substrings.size(); }
+
+    static void sort_matches(const uint64_t *rows, size_t row_words,
+                             const uint64_t *query, vector<Match> &matches);
+
+private:
+    struct Substring {
+        size_t first_bit;
+        size_t length;
+    };
+
+    // The ids of the codes whose substring has the value key are
+    // members[begin, end) of the Table. An empty Bucket has begin == end
+    struct Bucket {
+        uint64_t key;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    struct Table {
+        vector<Bucket> buckets;
+        size_t mask;
+        vector<int32_t> members;
+    };
+
+    // The state of one query: which codes have been checked, and the ones
+    // that were found along with how many were found at each distance, and
+    // how many buckets were looked up to find them
+    struct Search {
+        const uint64_t *query;
+        vector<bool> seen;
+        vector<Match> found;
+        vector<size_t> at_distance;
+        size_t lookups;
+    };
+
+    const uint64_t *rows;
+    size_t row_words;
+    size_t num_bits;
+    vector<int32_t> ids;
+    vector<Substring> substrings;
+    vector<Table> tables;
+
+    void build_table(size_t s);
+    uint64_t substring_of(const uint64_t *code, size_t s) const;
+    int distance_to(const uint64_t *query, int32_t id) const;
+    const Bucket *find_bucket(const Table &table, uint64_t key) const;
+    double lookups_at(int radius) const;
+
+    void start_search(const uint64_t *query, Search &search) const;
+    void check(int32_t k, Search &search) const;
+    void search_variants(size_t s, uint64_t key, size_t from_bit,
+                         int flips_left, Search &search) const;
+    void check_all(Search &search) const;
+};
+
+#endif
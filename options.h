@@ -0,0 +1,50 @@
+// options.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Definition of the BuildOptions struct, the settings given on the 
+//          command line that change how the KDtree and the index of 
+//          neighbors are built. Only the sampling settings change which tree
+//          is built, and only for the versions that sample
+//
+
+#include <cstddef>
+#include <stdint.h>
+
+#ifndef _OPTIONS_H_
+#define _OPTIONS_H_
+
+struct BuildOptions {
+    // Number of threads that build subtrees and parse entries files, 
+    // counting the main thread
+    int threads;
+    // Pools at least this large have their yes and no subtrees built as 
+    // separate tasks when threads is greater than one
+    size_t parallel_cutoff;
+    // Build only the root up front and expand the rest of the tree as it is
+    // reached
+    bool lazy;
+    // Versions 1.1 and 3.0 choose each question from a random sample of the
+    // pool, drawn from this seed, starting at sample_size entries. The 
+    // sample is doubled until the share of it that answers the chosen 
+    // question yes is known to within sample_tolerance, or never grown if 
+    // sample_tolerance is zero
+    uint64_t seed;
+    size_t sample_size;
+    double sample_tolerance;
+    // Search for neighbors with a radixTrie, which takes far less memory 
+    // than the multiIndexHash but looks at more of the entries per search
+    bool radix_neighbors;
+
+    BuildOptions()
+    {
+        threads = 1;
+        parallel_cutoff = 2048;
+        lazy = false;
+        seed = 20;
+        sample_size = 10;
+        sample_tolerance = 0.1;
+        radix_neighbors = false;
+    }
+};
+
+#endif
@@ -2,9 +2,12 @@
 // By: Miles Izydorczak
 // Date: 18 November 2019
 // Purpose: Contains struct definition for an Entry which will be used by 
-//          numerous other objects and files
+//          numerous other objects and files. The answers of the entries are
+//          not kept here but in a shared answerMatrix, so that they can be
+//          stored as packed bits
 //
 #include <vector>
+#include <string>
 #include "userInput.h"
 
 using namespace std;
@@ -14,11 +17,9 @@ using namespace std;
 
 struct Entry {
     string name;
-    vector<int> answers;
 };
 
 struct Question {
-    userInput truth;
     string question;
 };
 
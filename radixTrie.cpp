@@ -0,0 +1,274 @@
+// radixTrie.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the radixTrie class
+//
+
+#include <queue>
+#include <utility>
+#include <functional>
+#include "radixTrie.h"
+#include "runStats.h"
+
+using namespace std;
+
+static const uint32_t NO_NODE = 0xFFFFFFFF;
+
+// Constructor radixTrie
+// Parameters: The rows of a matrix of packed codes and the number of words in
+//             each, the number of bits in a code, and the ids of the rows to
+//             add, which must stay in place for as long as the radixTrie is
+//             used
+// Does:       Adds the codes one at a time. If two ids have the same code,
+//             the later one takes the leaf over
+radixTrie::radixTrie(const uint64_t *rows, size_t row_words, size_t num_bits,
+                     const vector<int32_t> &ids)
+{
+    this->rows = rows;
+    this->row_words = row_words;
+    this->num_bits = num_bits;
+    root = NO_NODE;
+    nodes.reserve(ids.size() * 2);
+    for (size_t i = 0; i < ids.size(); i++) {
+        insert(ids[i]);
+    }
+}
+
+// Function memory_bytes
+// Parameters: None
+// Returns:    The number of bytes that the Nodes take up
+size_t radixTrie::memory_bytes() const
+{
+    return nodes.capacity() * sizeof(Node);
+}
+
+// Function make_node
+// Parameters: The span of bits that label the edge into the new Node, and the
+//             id of a leaf below it
+// Returns:    The index of the new Node, which has no children
+uint32_t radixTrie::make_node(uint32_t first_bit, uint32_t end_bit,
+                              int32_t leaf)
+{
+    Node node;
+    node.first_bit = first_bit;
+    node.end_bit = end_bit;
+    node.child[0] = NO_NODE;
+    node.child[1] = NO_NODE;
+    node.leaf = leaf;
+    nodes.push_back(node);
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+// Function insert
+// Parameters: The id of a code
+// Returns:    None
+// Does:       Walks down from the root for as long as the code agrees with
+//             every label, following the code's bit at each branch. If the
+//             code reaches a leaf, it is a duplicate and takes the leaf over.
+//             If it first disagrees with a label, the edge is split at the
+//             first bit where they disagree: a new Node takes the part of the
+//             label before that bit and branches on it, to the old Node with
+//             the rest of the label on one side and a new leaf on the other
+void radixTrie::insert(int32_t id)
+{
+    const uint64_t *code = code_of(id);
+    if (root == NO_NODE) {
+        root = make_node(0, num_bits, id);
+        return;
+    }
+
+    uint32_t parent = NO_NODE, n = root;
+    bool side = false;
+    while (true) {
+        size_t first_bit = nodes[n].first_bit, end_bit = nodes[n].end_bit;
+        size_t differ = first_difference(code, code_of(nodes[n].leaf),
+                                         first_bit, end_bit);
+        if (differ < end_bit) {
+            uint32_t branch = make_node(first_bit, differ, nodes[n].leaf);
+            uint32_t leaf = make_node(differ + 1, num_bits, id);
+            nodes[n].first_bit = differ + 1;
+            bool bit = test_bit(code, differ);
+            nodes[branch].child[bit] = leaf;
+            nodes[branch].child[not bit] = n;
+            if (parent == NO_NODE) {
+                root = branch;
+            } else {
+                nodes[parent].child[side] = branch;
+            }
+            return;
+        } else if (end_bit == num_bits) {
+            nodes[n].leaf = id;
+            return;
+        }
+        parent = n;
+        side = test_bit(code, end_bit);
+        n = nodes[n].child[side];
+    }
+}
+
+// Function within
+// Parameters: A pointer to the packed words of a query, a radius, and a
+//             vector of Matches, passed by reference
+// Returns:    None
+// Does:       Sets matches to every code within the radius of the query, in
+//             order. Walks the trie depth first, carrying the number of bits
+//             that have disagreed with the query so far, and leaves out every
+//             edge that takes that number past the radius
+void radixTrie::within(const uint64_t *query, int radius,
+                       vector<Match> &matches) const
+{
+    matches.clear();
+    if (root == NO_NODE or radius < 0) {
+        return;
+    }
+
+    vector<pair<uint32_t, int> > stack;
+    stack.push_back(make_pair(root, 0));
+    size_t visited = 0;
+    while (not stack.empty()) {
+        uint32_t n = stack.back().first;
+        int distance = stack.back().second;
+        stack.pop_back();
+        visited++;
+
+        const Node &node = nodes[n];
+        distance += label_distance(query, n);
+        if (distance > radius) {
+            continue;
+        }
+        if (node.end_bit == num_bits) {
+            Match match = { node.leaf, distance };
+            matches.push_back(match);
+            continue;
+        }
+        bool bit = test_bit(query, node.end_bit);
+        stack.push_back(make_pair(node.child[bit], distance));
+        stack.push_back(make_pair(node.child[not bit], distance + 1));
+    }
+    runStats::add(runStats::TRIE_PROBES, visited);
+    multiIndexHash::sort_matches(rows, row_words, query, matches);
+}
+
+// Function nearest
+// Parameters: A pointer to the packed words of a query, the number of codes
+//             to find, k, and a vector of Matches, passed by reference
+// Returns:    None
+// Does:       Sets matches to the k codes nearest to the query, in order, or
+//             to every code if there are no more than k of them. Walks the
+//             trie best first: the edges still to be followed wait in a
+//             priority queue, ordered by how many bits have disagreed with
+//             the query on the way to them and along their own label, which
+//             can only grow further down. So leaves come out of the queue 
+//             nearest first, and once k of them have, the walk goes on only
+//             until the queue holds nothing as near as the kth, so that every
+//             code tied with it is found
+void radixTrie::nearest(const uint64_t *query, size_t k,
+                        vector<Match> &matches) const
+{
+    matches.clear();
+    if (root == NO_NODE or k == 0) {
+        return;
+    }
+
+    typedef pair<int, uint32_t> Waiting;
+    priority_queue<Waiting, vector<Waiting>, greater<Waiting> > waiting;
+    waiting.push(make_pair(label_distance(query, root), root));
+    size_t visited = 0;
+    while (not waiting.empty()) {
+        int distance = waiting.top().first;
+        uint32_t n = waiting.top().second;
+        if (matches.size() >= k and distance > matches[k - 1].distance) {
+            break;
+        }
+        waiting.pop();
+        visited++;
+
+        const Node &node = nodes[n];
+        if (node.end_bit == num_bits) {
+            Match match = { node.leaf, distance };
+            matches.push_back(match);
+            continue;
+        }
+        bool bit = test_bit(query, node.end_bit);
+        uint32_t same = node.child[bit], other = node.child[not bit];
+        waiting.push(make_pair(distance + label_distance(query, same), same));
+        waiting.push(make_pair(distance + 1 + label_distance(query, other),
+                               other));
+    }
+    runStats::add(runStats::TRIE_PROBES, visited);
+    multiIndexHash::sort_matches(rows, row_words, query, matches);
+    if (matches.size() > k) {
+        matches.resize(k);
+    }
+}
+
+// Function label_distance
+// Parameters: A pointer to the packed words of a query, and the index of a 
+//             Node
+// Returns:    The number of bits of the label of the edge into the Node that 
+//             disagree with the query
+int radixTrie::label_distance(const uint64_t *query, uint32_t n) const
+{
+    return span_distance(query, code_of(nodes[n].leaf), nodes[n].first_bit,
+                         nodes[n].end_bit);
+}
+
+// Function code_of
+// Parameters: The id of a code
+// Returns:    A pointer to the packed words of that code
+const uint64_t *radixTrie::code_of(int32_t id) const
+{
+    return rows + static_cast<size_t>(id) * row_words;
+}
+
+// Function test_bit
+// Parameters: A pointer to the packed words of a code, and the index of a bit
+// Returns:    The value of that bit
+bool radixTrie::test_bit(const uint64_t *code, size_t bit)
+{
+    return (code[bit >> 6] >> (bit & 63)) & 1;
+}
+
+// Function first_difference
+// Parameters: Pointers to the packed words of two codes, and a span of bits
+//             [first_bit, end_bit)
+// Returns:    The first bit of the span where the codes differ, or end_bit if
+//             they agree on all of it
+size_t radixTrie::first_difference(const uint64_t *a, const uint64_t *b,
+                                   size_t first_bit, size_t end_bit)
+{
+    size_t bit = first_bit;
+    while (bit < end_bit) {
+        size_t w = bit >> 6;
+        uint64_t differ = (a[w] ^ b[w]) >> (bit & 63);
+        if (differ != 0) {
+            bit += __builtin_ctzll(differ);
+            return bit < end_bit ? bit : end_bit;
+        }
+        bit = (w + 1) << 6;
+    }
+    return end_bit;
+}
+
+// Function span_distance
+// Parameters: Pointers to the packed words of two codes, and a span of bits
+//             [first_bit, end_bit)
+// Returns:    The number of bits of the span where the codes differ
+int radixTrie::span_distance(const uint64_t *a, const uint64_t *b,
+                             size_t first_bit, size_t end_bit)
+{
+    int distance = 0;
+    size_t bit = first_bit;
+    while (bit < end_bit) {
+        size_t w = bit >> 6;
+        size_t shift = bit & 63;
+        size_t count = min(static_cast<size_t>(64) - shift, end_bit - bit);
+        uint64_t differ = (a[w] ^ b[w]) >> shift;
+        if (count < 64) {
+            differ &= (static_cast<uint64_t>(1) << count) - 1;
+        }
+        distance += __builtin_popcountll(differ);
+        bit += count;
+    }
+    return distance;
+}
@@ -0,0 +1,73 @@
+// radixTrie.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the radixTrie class, a path-compressed (Patricia)
+//          binary trie of packed codes that answers the same Hamming distance
+//          queries as a multiIndexHash in a fraction of the memory. A chain
+//          of Nodes with a single child each is collapsed into one edge,
+//          labeled by the span of bits that every code below it shares, so
+//          every interior Node branches and a trie of N codes has fewer than
+//          2N Nodes however long the codes are. The bits of a label are not
+//          stored: they are read from the code of any leaf below the edge.
+//          Leaves hold nothing but the id of their code, which is also the
+//          index of the entry's name in the caller's string table, and ids
+//          with the same code share a leaf, the last of them kept. Searches
+//          walk down the trie counting how many bits of each label disagree
+//          with the query, and stop going down an edge once that count is too
+//          large. Results come in the same order as those of a multiIndexHash
+//
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+#include "multiIndexHash.h"
+
+using namespace std;
+
+#ifndef _RADIXTRIE_H_
+#define _RADIXTRIE_H_
+
+class radixTrie {
+public:
+    typedef multiIndexHash::Match Match;
+
+    radixTrie(const uint64_t *rows, size_t row_words, size_t num_bits,
+              const vector<int32_t> &ids);
+
+    void within(const uint64_t *query, int radius,
+                vector<Match> &matches) const;
+    void nearest(const uint64_t *query, size_t k,
+                 vector<Match> &matches) const;
+
+    size_t num_nodes() const { return nodes.size(); }
+    size_t memory_bytes() const;
+
+private:
+    // The edge into a Node is labeled by bits [first_bit, end_bit) of the
+    // code of leaf. An interior Node branches on bit end_bit, and a leaf has
+    // end_bit == num_bits and no children
+    struct Node {
+        uint32_t first_bit;
+        uint32_t end_bit;
+        uint32_t child[2];
+        int32_t leaf;
+    };
+
+    const uint64_t *rows;
+    size_t row_words;
+    size_t num_bits;
+    vector<Node> nodes;
+    uint32_t root;
+
+    void insert(int32_t id);
+    uint32_t make_node(uint32_t first_bit, uint32_t end_bit, int32_t leaf);
+    int label_distance(const uint64_t *query, uint32_t n) const;
+    const uint64_t *code_of(int32_t id) const;
+    static bool test_bit(const uint64_t *code, size_t bit);
+    static size_t first_difference(const uint64_t *a, const uint64_t *b,
+                                   size_t first_bit, size_t end_bit);
+    static int span_distance(const uint64_t *a, const uint64_t *b,
+                             size_t first_bit, size_t end_bit);
+};
+
+#endif
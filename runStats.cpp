@@ -0,0 +1,102 @@
+// runStats.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the runStats class
+//
+
+#include <iostream>
+#include <cstdlib>
+#include <sys/resource.h>
+#include "runStats.h"
+#include "splitKernels.h"
+
+using namespace std;
+
+atomic<uint64_t> runStats::counts[NUM_COUNTERS];
+atomic<uint64_t> runStats::phase_nanoseconds[NUM_PHASES];
+bool runStats::json_report = false;
+
+// The names of the counters and phases, in the order of their enums, as
+// they are printed in the summary and in the JSON
+static const char *const COUNTER_NAMES[] = {
+    "nodes_made", "questions_scored", "answers_counted", "trie_probes",
+    "games_started", "questions_skipped", "backtracks"
+};
+static const char *const PHASE_NAMES[] = { "load", "build", "play" };
+
+// Constructor Timer
+// Parameters: The phase to add the time to
+// Does:       Starts timing
+runStats::Timer::Timer(Phase phase)
+{
+    this->phase = phase;
+    start = chrono::steady_clock::now();
+}
+
+// Destructor ~Timer
+// Does: Adds the time since the Timer was made to its phase. Phases that
+//       run on several threads at once, such as a neighbor index built
+//       while a game is played, add up the time of each
+runStats::Timer::~Timer()
+{
+    chrono::nanoseconds spent = chrono::steady_clock::now() - start;
+    phase_nanoseconds[phase].fetch_add(spent.count(), memory_order_relaxed);
+}
+
+// Function report_at_exit
+// Parameters: A bool, true to report as JSON rather than as a summary
+// Returns:    None
+// Does:       Has the report printed when the program exits, however it
+//             exits normally
+void runStats::report_at_exit(bool json)
+{
+    json_report = json;
+    atexit(report);
+}
+
+// Function peak_rss_kb
+// Parameters: None
+// Returns:    The most memory that the process has had resident at once, in
+//             kilobytes, or 0 if the system will not say
+long runStats::peak_rss_kb()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+
+// Function report
+// Parameters: None
+// Returns:    None
+// Does:       Prints the split kernels in use, the time of each phase in
+//             seconds, the peak resident set size and every counter to
+//             standard error, one to a line, or as a single JSON object
+void runStats::report()
+{
+    if (json_report) {
+        cerr << "{\"split_kernel\": \"" << split_kernel_name() << "\", ";
+        for (int i = 0; i < NUM_PHASES; i++) {
+            cerr << "\"" << PHASE_NAMES[i] << "_seconds\": "
+                 << phase_nanoseconds[i].load() / 1e9 << ", ";
+        }
+        cerr << "\"peak_rss_kb\": " << peak_rss_kb();
+        for (int i = 0; i < NUM_COUNTERS; i++) {
+            cerr << ", \"" << COUNTER_NAMES[i] << "\": " << counts[i].load();
+        }
+        cerr << "}" << endl;
+        return;
+    }
+
+    cerr << "Stats:" << endl;
+    cerr << "  split kernel: " << split_kernel_name() << endl;
+    for (int i = 0; i < NUM_PHASES; i++) {
+        cerr << "  " << PHASE_NAMES[i] << " seconds: "
+             << phase_nanoseconds[i].load() / 1e9 << endl;
+    }
+    cerr << "  peak RSS (KB): " << peak_rss_kb() << endl;
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        cerr << "  " << COUNTER_NAMES[i] << ": " << counts[i].load() << endl;
+    }
+}
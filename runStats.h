@@ -0,0 +1,78 @@
+// runStats.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the runStats class, the counters and timers that the
+//          game keeps of its own work as it runs, so that where the time and
+//          memory of a catalog go can be seen without a profiler. The
+//          counters count the work of the hottest loops of the tree, the
+//          neighbor index and the game, the timers add up the time spent
+//          loading, building and playing, and the peak resident set size is
+//          read from the system. Everything is kept in relaxed atomics,
+//          which the hot loops add to once per call rather than once per
+//          step, so counting costs next to nothing and is always on. With
+//          --stats, a report of all of it is printed to standard error when
+//          the program exits, as a summary or as JSON
+//
+
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <stdint.h>
+
+using namespace std;
+
+#ifndef _RUNSTATS_H_
+#define _RUNSTATS_H_
+
+class runStats {
+public:
+    enum Counter {
+        // Nodes made in a KDtree's arena, whether built up front or lazily
+        NODES_MADE,
+        // Questions scored by how evenly they split a pool, and the answers
+        // counted to score them
+        QUESTIONS_SCORED,
+        ANSWERS_COUNTED,
+        // Hash buckets looked up and codes compared by the multiIndexHash,
+        // or nodes visited by the radixTrie, while searching for neighbors
+        TRIE_PROBES,
+        // Games begun, questions passed over because they had already been
+        // answered, and returns to a probably or unknown after a bad guess
+        GAMES_STARTED,
+        QUESTIONS_SKIPPED,
+        BACKTRACKS,
+        NUM_COUNTERS
+    };
+
+    // A tree built on the first B of a game is timed as both building and
+    // playing, since the player waits on it
+    enum Phase { LOAD, BUILD, PLAY, NUM_PHASES };
+
+    // Adds the time from its making to its destruction to a phase
+    class Timer {
+    public:
+        Timer(Phase phase);
+        ~Timer();
+
+    private:
+        Phase phase;
+        chrono::steady_clock::time_point start;
+    };
+
+    static void add(Counter counter, uint64_t amount = 1)
+    {
+        counts[counter].fetch_add(amount, memory_order_relaxed);
+    }
+
+    static void report_at_exit(bool json);
+
+private:
+    static atomic<uint64_t> counts[NUM_COUNTERS];
+    static atomic<uint64_t> phase_nanoseconds[NUM_PHASES];
+    static bool json_report;
+
+    static long peak_rss_kb();
+    static void report();
+};
+
+#endif
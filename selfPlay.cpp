@@ -0,0 +1,157 @@
+// selfPlay.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the selfPlay class. Each game is a gameSession
+//          like any other, answered with the words that a player would type,
+//          so the numbers that it reports are those of the game as it is
+//          really played
+//
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include "selfPlay.h"
+#include "dataset.h"
+
+using namespace std;
+
+// Constructor selfPlay
+// Parameters: The TwentyQgame to play, passed by reference, whose tree,
+//             neighbor index and dataset must all have been made already,
+//             the share of noisy answers, and the seed that they are drawn
+//             from
+// Does:       Sets up a run of games that has not been played yet
+selfPlay::selfPlay(TwentyQgame &game, double noise, uint64_t seed)
+    : random(seed)
+{
+    this->game = &game;
+    this->noise = noise;
+    games_played = 0;
+    play_seconds = 0;
+}
+
+// Function play_all
+// Parameters: None
+// Returns:    None
+// Does:       Plays a game for every entry of the dataset, in order, one at a
+//             time, and times them all together
+void selfPlay::play_all()
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t entry = 0; entry < game->data->num_entries(); entry++) {
+        int answers_given;
+        if (play(entry, answers_given)) {
+            winning_lengths.push_back(answers_given);
+        }
+        games_played++;
+    }
+    play_seconds = chrono::duration<double>(chrono::steady_clock::now() -
+                                            start).count();
+}
+
+// Function play
+// Parameters: The index of the entry that the player is thinking of, and the
+//             number of answers given, passed by reference
+// Returns:    A bool, true if the game was won by guessing the entry
+// Does:       Begins a game and answers everything that it asks until it is
+//             over. A guess is right if it names the entry, since the player
+//             cannot tell apart two entries with the same name. The answer
+//             that begins the game is not counted
+bool selfPlay::play(size_t entry, int &answers_given)
+{
+    const string &name = game->data->entry_name(entry);
+    gameSession session(*game);
+    session.start();
+    session.answer(string("B"));
+
+    answers_given = 0;
+    bool won = false;
+    while (not session.finished()) {
+        string guess = session.guess_made();
+        string answer;
+        if (not guess.empty()) {
+            won = guess == name;
+            answer = won ? "y" : "n";
+        } else {
+            answer = answer_question(entry, session.question_asked());
+        }
+        session.answer(answer);
+        answers_given++;
+    }
+    return won;
+}
+
+// Function answer_question
+// Parameters: The index of the entry that the player is thinking of, and the
+//             index of the question asked, or -1 if there is none
+// Returns:    The player's answer, the entry's own answer to the question
+//             unless it is made noisy. Where there is no question to answer,
+//             version 2.0 is told that the answer is unknown and the other
+//             versions, which only take yes or no, are told no
+string selfPlay::answer_question(size_t entry, int q_index)
+{
+    const answerMatrix &answers = game->data->answers();
+    if (q_index < 0 or static_cast<size_t>(q_index) >=
+                       answers.num_questions()) {
+        return game->version_num == 2.0 ? "unknown" : "n";
+    }
+    bool truth = answers.get(entry, q_index);
+    if (noise > 0 and
+        uniform_real_distribution<double>(0, 1)(random) < noise) {
+        return noisy_answer(truth);
+    }
+    return truth ? "y" : "n";
+}
+
+// Function noisy_answer
+// Parameters: The entry's own answer to a question
+// Returns:    An answer that is not quite it. Version 2.0 is given the wrong
+//             answer, an answer of probably or probably not that leans the
+//             right way, or unknown, each as often as the others, which sends
+//             it back through its probablies and unknowns after a wrong
+//             guess. The other versions only take yes or no, so they are
+//             given the wrong answer
+string selfPlay::noisy_answer(bool truth)
+{
+    int kind = game->version_num == 2.0 ?
+               uniform_int_distribution<int>(0, 2)(random) : 0;
+    if (kind == 0) {
+        return truth ? "n" : "y";
+    } else if (kind == 1) {
+        return truth ? "prob" : "probnot";
+    }
+    return "unknown";
+}
+
+// Function report
+// Parameters: The number of seconds that it took to build the tree and the
+//             neighbor index
+// Returns:    None
+// Does:       Prints how long the tree took to build, how many games were
+//             played a second, the share of them that were won, and the mean
+//             and 99th percentile of the answers that it took to win
+void selfPlay::report(double build_seconds)
+{
+    size_t wins = winning_lengths.size();
+    double mean = 0;
+    int p99 = 0;
+    if (wins > 0) {
+        sort(winning_lengths.begin(), winning_lengths.end());
+        for (size_t i = 0; i < wins; i++) {
+            mean += winning_lengths[i];
+        }
+        mean /= wins;
+        p99 = winning_lengths[(wins * 99 + 99) / 100 - 1];
+    }
+
+    cout << "Games played:      " << games_played << endl;
+    cout << "Noise:             " << noise << endl;
+    cout << "Build time (s):    " << build_seconds << endl;
+    cout << "Play time (s):     " << play_seconds << endl;
+    cout << "Games per second:  "
+         << (play_seconds > 0 ? games_played / play_seconds : 0) << endl;
+    cout << "Win rate:          "
+         << (games_played > 0 ? 100.0 * wins / games_played : 0) << "%"
+         << endl;
+    cout << "Answers to win:    mean " << mean << ", p99 " << p99 << endl;
+}
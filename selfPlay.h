@@ -0,0 +1,51 @@
+// selfPlay.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the selfPlay class, which plays one game of a
+//          TwentyQgame for every entry of its dataset with no one at the
+//          keyboard. The player of each game thinks of the entry and answers
+//          every question from the entry's own answers, so a game is only
+//          lost when the tree cannot tell the entry apart from the others.
+//          A share of the answers can be made noisy, to see how well each
+//          version copes with a player who makes mistakes. It reports how
+//          many games were played a second, how many were won, and how many
+//          answers it took to win them, which gives a repeatable measure of
+//          the game and a workload to profile it with
+//
+
+#include <string>
+#include <vector>
+#include <random>
+#include <stdint.h>
+#include "TwentyQgame.h"
+#include "gameSession.h"
+
+using namespace std;
+
+#ifndef _SELFPLAY_H_
+#define _SELFPLAY_H_
+
+class selfPlay {
+public:
+    selfPlay(TwentyQgame &game, double noise, uint64_t seed);
+
+    void play_all();
+    void report(double build_seconds);
+
+private:
+    TwentyQgame *game;
+    // The share of the answers to questions that are not the entry's own
+    double noise;
+    mt19937_64 random;
+
+    size_t games_played;
+    double play_seconds;
+    // The number of answers that it took to win each game that was won
+    vector<int> winning_lengths;
+
+    bool play(size_t entry, int &answers_given);
+    string answer_question(size_t entry, int q_index);
+    string noisy_answer(bool truth);
+};
+
+#endif
@@ -0,0 +1,455 @@
+// splitKernels.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the split counting kernels and of the cpuid
+//          check that decides which version of them to run. The vector
+//          versions are compiled with target attributes rather than with
+//          global compiler flags, so the executable still runs on processors
+//          that lack those instructions
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "splitKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SPLIT_KERNELS_X86 1
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+
+using namespace std;
+
+// The columns are counted in blocks of this many words (16384 entries), so
+// that the block of the pool's bitset stays in the L1 cache while every
+// question's column streams past it
+static const size_t BLOCK_WORDS = 256;
+
+struct kernelTable {
+    const char *name;
+    void (*count_block)(const uint64_t *columns, size_t column_words,
+                        const uint64_t *pool, size_t n, size_t num_qs,
+                        int *counts);
+    void (*add_row)(const uint64_t *row, size_t num_qs, int *counts);
+    void (*subtract)(int *counts, const int *minus, size_t num_qs);
+};
+
+// Function count_block_scalar
+// Parameters: A pointer to the first column at the start of a block, the
+//             number of words between two columns, the pool's bitset at the
+//             start of the block, the number of words in the block, the
+//             number of questions and the counts to add to
+// Returns:    None
+// Does:       Adds the popcount of each column ANDed with the pool to that
+//             column's count, one word at a time
+static void count_block_scalar(const uint64_t *columns, size_t column_words,
+                               const uint64_t *pool, size_t n, size_t num_qs,
+                               int *counts)
+{
+    for (size_t q = 0; q < num_qs; q++) {
+        const uint64_t *col = columns + q * column_words;
+        int number_yes = 0;
+        for (size_t w = 0; w < n; w++) {
+            number_yes += __builtin_popcountll(col[w] & pool[w]);
+        }
+        counts[q] += number_yes;
+    }
+}
+
+// Function add_row_scalar
+// Parameters: A row of packed answers, the number of questions in it and the
+//             counts to add to
+// Returns:    None
+// Does:       Adds one to the count of every question that the row answers
+//             yes, visiting only the set bits of the row
+static void add_row_scalar(const uint64_t *row, size_t num_qs, int *counts)
+{
+    for (size_t w = 0; w * 64 < num_qs; w++) {
+        uint64_t bits = row[w];
+        while (bits != 0) {
+            size_t q = w * 64 + __builtin_ctzll(bits);
+            if (q >= num_qs) {
+                break;
+            }
+            counts[q]++;
+            bits &= bits - 1;
+        }
+    }
+}
+
+// Function subtract_scalar
+// Parameters: An array of counts, an array of counts to take away from them,
+//             and the number of counts in each
+// Returns:    None
+static void subtract_scalar(int *counts, const int *minus, size_t num_qs)
+{
+    for (size_t q = 0; q < num_qs; q++) {
+        counts[q] -= minus[q];
+    }
+}
+
+#ifdef SPLIT_KERNELS_X86
+
+// Function count_block_popcnt
+// Does: The same as count_block_scalar, but compiled to use the POPCNT
+//       instruction instead of a portable bit counting routine
+__attribute__((target("popcnt")))
+static void count_block_popcnt(const uint64_t *columns, size_t column_words,
+                               const uint64_t *pool, size_t n, size_t num_qs,
+                               int *counts)
+{
+    for (size_t q = 0; q < num_qs; q++) {
+        const uint64_t *col = columns + q * column_words;
+        int number_yes = 0;
+        for (size_t w = 0; w < n; w++) {
+            number_yes += __builtin_popcountll(col[w] & pool[w]);
+        }
+        counts[q] += number_yes;
+    }
+}
+
+// Function count_block_avx2
+// Does: The same as count_block_scalar, four words at a time. AVX2 has no
+//       popcount instruction, so each byte is counted by looking its two
+//       nibbles up in a table with VPSHUFB, and the byte counts are summed
+//       into 64 bit lanes with VPSADBW
+__attribute__((target("avx2,popcnt")))
+static void count_block_avx2(const uint64_t *columns, size_t column_words,
+                             const uint64_t *pool, size_t n, size_t num_qs,
+                             int *counts)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+                                            1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3,
+                                            1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (size_t q = 0; q < num_qs; q++) {
+        const uint64_t *col = columns + q * column_words;
+        __m256i total = zero;
+        size_t w = 0;
+        for (; w + 4 <= n; w += 4) {
+            __m256i c = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(col + w));
+            __m256i p = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(pool + w));
+            __m256i v = _mm256_and_si256(c, p);
+            __m256i lo = _mm256_and_si256(v, low_mask);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+            __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                            _mm256_shuffle_epi8(lookup, hi));
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, zero));
+        }
+
+        uint64_t number_yes =
+            static_cast<uint64_t>(_mm256_extract_epi64(total, 0)) +
+            static_cast<uint64_t>(_mm256_extract_epi64(total, 1)) +
+            static_cast<uint64_t>(_mm256_extract_epi64(total, 2)) +
+            static_cast<uint64_t>(_mm256_extract_epi64(total, 3));
+        for (; w < n; w++) {
+            number_yes += _mm_popcnt_u64(col[w] & pool[w]);
+        }
+        counts[q] += static_cast<int>(number_yes);
+    }
+}
+
+// Function add_row_avx2
+// Does: The same as add_row_scalar, eight questions at a time. Each byte of
+//       the row is broadcast to eight lanes and compared against the bit of
+//       each lane, which gives -1 in the lanes of the questions answered yes
+//       and 0 elsewhere, and that is subtracted from the counts
+__attribute__((target("avx2")))
+static void add_row_avx2(const uint64_t *row, size_t num_qs, int *counts)
+{
+    const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(row);
+
+    size_t q = 0;
+    for (; q + 8 <= num_qs; q += 8) {
+        __m256i b = _mm256_and_si256(_mm256_set1_epi32(bytes[q >> 3]),
+                                     lane_bits);
+        __m256i yes_lanes = _mm256_cmpeq_epi32(b, lane_bits);
+        __m256i *dst = reinterpret_cast<__m256i *>(counts + q);
+        _mm256_storeu_si256(dst, _mm256_sub_epi32(_mm256_loadu_si256(dst),
+                                                  yes_lanes));
+    }
+    for (; q < num_qs; q++) {
+        counts[q] += (row[q >> 6] >> (q & 63)) & 1;
+    }
+}
+
+// Function subtract_avx2
+// Does: The same as subtract_scalar, eight counts at a time
+__attribute__((target("avx2")))
+static void subtract_avx2(int *counts, const int *minus, size_t num_qs)
+{
+    size_t q = 0;
+    for (; q + 8 <= num_qs; q += 8) {
+        __m256i *dst = reinterpret_cast<__m256i *>(counts + q);
+        __m256i m = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(minus + q));
+        _mm256_storeu_si256(dst, _mm256_sub_epi32(_mm256_loadu_si256(dst),
+                                                  m));
+    }
+    for (; q < num_qs; q++) {
+        counts[q] -= minus[q];
+    }
+}
+
+// Function count_block_avx512
+// Does: The same as count_block_scalar, eight words at a time, using the
+//       VPOPCNTQ instruction. The last partial group of words is read with
+//       a masked load so that no word past the end of the block is touched
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static void count_block_avx512(const uint64_t *columns, size_t column_words,
+                               const uint64_t *pool, size_t n, size_t num_qs,
+                               int *counts)
+{
+    size_t full = n & ~static_cast<size_t>(7);
+    __mmask8 tail_mask = static_cast<__mmask8>((1u << (n - full)) - 1);
+
+    for (size_t q = 0; q < num_qs; q++) {
+        const uint64_t *col = columns + q * column_words;
+        __m512i total = _mm512_setzero_si512();
+        for (size_t w = 0; w < full; w += 8) {
+            __m512i v = _mm512_and_si512(_mm512_loadu_si512(col + w),
+                                         _mm512_loadu_si512(pool + w));
+            total = _mm512_add_epi64(total, _mm512_popcnt_epi64(v));
+        }
+        if (tail_mask != 0) {
+            __m512i v = _mm512_and_si512(
+                _mm512_maskz_loadu_epi64(tail_mask, col + full),
+                _mm512_maskz_loadu_epi64(tail_mask, pool + full));
+            total = _mm512_add_epi64(total, _mm512_popcnt_epi64(v));
+        }
+        counts[q] += static_cast<int>(_mm512_reduce_add_epi64(total));
+    }
+}
+
+// Function add_row_avx512
+// Does: The same as add_row_scalar, sixteen questions at a time. Sixteen bits
+//       of the row are used directly as the write mask of an add of one
+__attribute__((target("avx512f")))
+static void add_row_avx512(const uint64_t *row, size_t num_qs, int *counts)
+{
+    const __m512i ones = _mm512_set1_epi32(1);
+    for (size_t q = 0; q < num_qs; q += 16) {
+        size_t left = num_qs - q;
+        __mmask16 lanes = left >= 16 ? 0xFFFF
+                        : static_cast<__mmask16>((1u << left) - 1);
+        __mmask16 yes_lanes = static_cast<__mmask16>(
+            (row[q >> 6] >> (q & 63)) & lanes);
+        __m512i v = _mm512_maskz_loadu_epi32(lanes, counts + q);
+        v = _mm512_mask_add_epi32(v, yes_lanes, v, ones);
+        _mm512_mask_storeu_epi32(counts + q, lanes, v);
+    }
+}
+
+// Function subtract_avx512
+// Does: The same as subtract_scalar, sixteen counts at a time, the last 
+//       group masked
+__attribute__((target("avx512f")))
+static void subtract_avx512(int *counts, const int *minus, size_t num_qs)
+{
+    for (size_t q = 0; q < num_qs; q += 16) {
+        size_t left = num_qs - q;
+        __mmask16 lanes = left >= 16 ? 0xFFFF
+                        : static_cast<__mmask16>((1u << left) - 1);
+        __m512i c = _mm512_maskz_loadu_epi32(lanes, counts + q);
+        __m512i m = _mm512_maskz_loadu_epi32(lanes, minus + q);
+        _mm512_mask_storeu_epi32(counts + q, lanes, _mm512_sub_epi32(c, m));
+    }
+}
+
+// Function read_xcr0
+// Parameters: None
+// Returns:    The low word of the XCR0 register, which tells us which vector
+//             registers the operating system saves on a context switch
+static uint64_t read_xcr0()
+{
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
+#endif
+
+// Function choose_kernels
+// Parameters: None
+// Returns:    A kernelTable, the kernels to use for the rest of the program
+// Does:       Asks cpuid which instructions the processor has, and XCR0
+//             whether the operating system has enabled the registers they
+//             use, then picks the widest kernels that will run. The choice
+//             can be overriden with the TWENTYQ_KERNEL environment variable,
+//             though never to a version that the processor cannot run
+static kernelTable choose_kernels()
+{
+    kernelTable scalar = { "scalar", count_block_scalar, add_row_scalar,
+                           subtract_scalar };
+#ifdef SPLIT_KERNELS_X86
+    kernelTable popcnt = { "popcnt", count_block_popcnt, add_row_scalar,
+                           subtract_scalar };
+    kernelTable avx2 = { "avx2", count_block_avx2, add_row_avx2,
+                         subtract_avx2 };
+    kernelTable avx512 = { "avx512", count_block_avx512, add_row_avx512,
+                           subtract_avx512 };
+
+    unsigned int a, b, c, d;
+    bool has_popcnt = false, has_avx2 = false, has_avx512 = false;
+    if (__get_cpuid(1, &a, &b, &c, &d)) {
+        has_popcnt = c & (1u << 23);
+        bool os_saves_regs = c & (1u << 27);
+        uint64_t xcr0 = os_saves_regs ? read_xcr0() : 0;
+        bool ymm_enabled = (xcr0 & 0x06) == 0x06;
+        bool zmm_enabled = (xcr0 & 0xE6) == 0xE6;
+        if (__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+            has_avx2 = ymm_enabled and has_popcnt and (b & (1u << 5));
+            has_avx512 = zmm_enabled and (b & (1u << 16)) and
+                         (c & (1u << 14));
+        }
+    }
+
+    const char *forced = getenv("TWENTYQ_KERNEL");
+    string wanted = forced == nullptr ? "" : forced;
+    if (wanted == "scalar") {
+        return scalar;
+    } else if (wanted == "popcnt" and has_popcnt) {
+        return popcnt;
+    } else if (wanted == "avx2" and has_avx2) {
+        return avx2;
+    } else if (wanted == "avx512" and has_avx512) {
+        return avx512;
+    }
+
+    if (has_avx512) {
+        return avx512;
+    } else if (has_avx2) {
+        return avx2;
+    } else if (has_popcnt) {
+        return popcnt;
+    }
+#endif
+    return scalar;
+}
+
+// Function kernels
+// Parameters: None
+// Returns:    A reference to the kernelTable chosen for this processor
+// Does:       Chooses the kernels the first time it is called, and returns
+//             the same choice on every later call
+static const kernelTable &kernels()
+{
+    static const kernelTable table = choose_kernels();
+    return table;
+}
+
+// Function count_yes_columns
+// Parameters: A question-major matrix of columns, each column_words long, a
+//             bitset of the entries in a pool, the range of words [first_word,
+//             last_word) of the bitset that may hold set bits, the number of
+//             questions, and an array of num_qs counts to write into
+// Returns:    None
+// Does:       Sets counts[q] to the number of entries in the pool whose
+//             answer to question q is yes, working through the range in
+//             blocks and counting every question's column within a block
+//             before moving to the next
+void count_yes_columns(const uint64_t *columns, size_t column_words,
+                       const uint64_t *pool_bits, size_t first_word,
+                       size_t last_word, size_t num_qs, int *counts)
+{
+    const kernelTable &k = kernels();
+    memset(counts, 0, num_qs * sizeof(int));
+    for (size_t block = first_word; block < last_word; block += BLOCK_WORDS) {
+        size_t n = last_word - block;
+        if (n > BLOCK_WORDS) {
+            n = BLOCK_WORDS;
+        }
+        k.count_block(columns + block, column_words, pool_bits + block, n,
+                      num_qs, counts);
+    }
+}
+
+// Function add_row_counts
+// Parameters: A row of packed answers, the number of questions, and an array
+//             of counts
+// Returns:    None
+// Does:       Adds one to counts[q] for every question q the row answers yes
+void add_row_counts(const uint64_t *row, size_t num_qs, int *counts)
+{
+    kernels().add_row(row, num_qs, counts);
+}
+
+// Function subtract_counts
+// Parameters: An array of counts, an array of counts to take away from them,
+//             and the number of counts in each
+// Returns:    None
+// Does:       Takes minus[q] away from counts[q] for every question q
+void subtract_counts(int *counts, const int *minus, size_t num_qs)
+{
+    kernels().subtract(counts, minus, num_qs);
+}
+
+// Function count_yes_rows
+// Parameters: The rows of a matrix of packed answers and the number of words
+//             in each, the indices of the entries in a pool and how many 
+//             there are, the number of questions, and an array of num_qs 
+//             counts to write into
+// Returns:    None
+// Does:       Sets counts[q] to the number of entries in the pool whose 
+//             answer to question q is yes, using bit-sliced counters: for 
+//             every word of a row, a stack of words holds the counts of its 
+//             64 questions in binary, bit b of every count in plane b. A row
+//             is added with a ripple of carries through the planes, which 
+//             usually stops after a plane or two, so a row costs a few word
+//             operations per 64 questions rather than one per yes answer. The
+//             planes are turned back into counts once, at the end
+void count_yes_rows(const uint64_t *rows, size_t row_words, const int *pool,
+                    size_t pool_size, size_t num_qs, int *counts)
+{
+    size_t num_planes = 1;
+    while ((static_cast<size_t>(1) << num_planes) <= pool_size) {
+        num_planes++;
+    }
+    size_t words = (num_qs + 63) / 64;
+    vector<uint64_t> planes(words * num_planes, 0);
+
+    for (size_t j = 0; j < pool_size; j++) {
+        const uint64_t *row = rows + static_cast<size_t>(pool[j]) * row_words;
+        for (size_t w = 0; w < words; w++) {
+            uint64_t *plane = planes.data() + w * num_planes;
+            uint64_t carry = row[w];
+            for (size_t b = 0; carry != 0; b++) {
+                uint64_t next = plane[b] & carry;
+                plane[b] ^= carry;
+                carry = next;
+            }
+        }
+    }
+
+    memset(counts, 0, num_qs * sizeof(int));
+    for (size_t w = 0; w < words; w++) {
+        const uint64_t *plane = planes.data() + w * num_planes;
+        for (size_t b = 0; b < num_planes; b++) {
+            uint64_t bits = plane[b];
+            while (bits != 0) {
+                size_t q = w * 64 + __builtin_ctzll(bits);
+                if (q >= num_qs) {
+                    break;
+                }
+                counts[q] += 1 << b;
+                bits &= bits - 1;
+            }
+        }
+    }
+}
+
+// Function split_kernel_name
+// Parameters: None
+// Returns:    The name of the kernels in use: scalar, popcnt, avx2 or avx512
+const char *split_kernel_name()
+{
+    return kernels().name;
+}
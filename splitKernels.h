@@ -0,0 +1,30 @@
+// splitKernels.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the counting kernels that score candidate splits of a
+//          pool of entries. Each kernel has a portable scalar version and, on
+//          x86, versions for AVX2 and for AVX-512 with VPOPCNTQ. The fastest
+//          version that the processor supports is chosen once, the first time
+//          a kernel is called, by checking cpuid. Setting the environment
+//          variable TWENTYQ_KERNEL to scalar, avx2 or avx512 forces a version
+//
+
+#include <cstddef>
+#include <stdint.h>
+
+#ifndef _SPLITKERNELS_H_
+#define _SPLITKERNELS_H_
+
+void count_yes_columns(const uint64_t *columns, size_t column_words,
+                       const uint64_t *pool_bits, size_t first_word,
+                       size_t last_word, size_t num_qs, int *counts);
+
+void add_row_counts(const uint64_t *row, size_t num_qs, int *counts);
+void subtract_counts(int *counts, const int *minus, size_t num_qs);
+
+void count_yes_rows(const uint64_t *rows, size_t row_words, const int *pool,
+                    size_t pool_size, size_t num_qs, int *counts);
+
+const char *split_kernel_name();
+
+#endif
@@ -0,0 +1,189 @@
+// taskPool.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the taskPool class
+//
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "taskPool.h"
+
+using namespace std;
+
+// The index of the queue that belongs to the calling thread, or -1 for a
+// thread that is not one of the pool's workers
+static thread_local int worker_index = -1;
+
+// Constructor taskPool
+// Parameters: An integer, the number of threads that will run tasks,
+//             counting the thread that creates the pool
+// Does:       Makes one queue per thread, then starts num_threads - 1 worker
+//             threads. The creating thread uses queue 0
+taskPool::taskPool(int num_threads)
+{
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    queued = 0;
+    stopping = false;
+
+    for (int i = 0; i < num_threads; i++) {
+        queues.push_back(new Queue);
+    }
+    for (int i = 1; i < num_threads; i++) {
+        workers.push_back(thread(&taskPool::worker_loop, this, i));
+    }
+}
+
+// Destructor ~taskPool
+// Does: Tells every worker to stop, waits for them to finish, then recycles
+//       the queues. Assumes that every spawned task has been waited on
+taskPool::~taskPool()
+{
+    {
+        lock_guard<mutex> guard(sleep_lock);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    for (size_t i = 0; i < queues.size(); i++) {
+        delete queues[i];
+    }
+}
+
+// Function size
+// Parameters: None
+// Returns:    An integer, the number of threads that run tasks
+int taskPool::size()
+{
+    return static_cast<int>(queues.size());
+}
+
+// Function my_index
+// Parameters: None
+// Returns:    The index of the calling thread's queue. Threads outside of the
+//             pool share queue 0 with the thread that created it
+int taskPool::my_index()
+{
+    if (worker_index < 0 or worker_index >= size()) {
+        return 0;
+    }
+    return worker_index;
+}
+
+// Function spawn
+// Parameters: A function to run, and a counter of pending tasks, passed by
+//             reference, which the caller will later wait on
+// Returns:    None
+// Does:       Adds one to the counter, then pushes the task onto the back of
+//             the calling thread's queue and wakes a sleeping worker to come
+//             and steal it
+void taskPool::spawn(function<void()> task, atomic<int> &pending)
+{
+    pending++;
+
+    Task new_task;
+    new_task.run = task;
+    new_task.pending = &pending;
+
+    Queue *mine = queues[my_index()];
+    {
+        lock_guard<mutex> guard(mine->lock);
+        mine->tasks.push_back(new_task);
+    }
+    {
+        lock_guard<mutex> guard(sleep_lock);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+// Function wait
+// Parameters: A counter of pending tasks, passed by reference
+// Returns:    None
+// Does:       Runs tasks, our own first and then stolen ones, until every
+//             task counted by the given counter has finished
+void taskPool::wait(atomic<int> &pending)
+{
+    int self = my_index();
+    Task task;
+    while (pending.load() > 0) {
+        if (pop_or_steal(self, task)) {
+            run_task(task);
+        } else {
+            this_thread::yield();
+        }
+    }
+}
+
+// Function pop_or_steal
+// Parameters: The index of the calling thread's queue, and a Task, passed by
+//             reference, to fill in
+// Returns:    A bool, true if a task was found
+// Does:       Takes the newest task from the back of our own queue. If it is
+//             empty, goes around the other queues and takes the oldest task
+//             from the front of the first one that has any. The oldest tasks
+//             are the ones closest to the root of the fork/join tree, so a
+//             thief takes the largest piece of work that is available
+bool taskPool::pop_or_steal(int self, Task &task)
+{
+    int n = size();
+    for (int i = 0; i < n; i++) {
+        Queue *q = queues[(self + i) % n];
+        lock_guard<mutex> guard(q->lock);
+        if (not q->tasks.empty()) {
+            if (i == 0) {
+                task = q->tasks.back();
+                q->tasks.pop_back();
+            } else {
+                task = q->tasks.front();
+                q->tasks.pop_front();
+            }
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function run_task
+// Parameters: A Task, passed by reference
+// Returns:    None
+// Does:       Runs the task and then marks it as finished in its counter
+void taskPool::run_task(Task &task)
+{
+    task.run();
+    (*task.pending)--;
+}
+
+// Function worker_loop
+// Parameters: The index of this worker's queue
+// Returns:    None
+// Does:       Body of every worker thread. Runs tasks for as long as any can
+//             be found, and sleeps until a new one is spawned otherwise.
+//             Returns once the pool is stopping
+void taskPool::worker_loop(int self)
+{
+    worker_index = self;
+    Task task;
+    while (true) {
+        if (pop_or_steal(self, task)) {
+            run_task(task);
+            continue;
+        }
+
+        unique_lock<mutex> guard(sleep_lock);
+        wake.wait(guard, [this]() { return stopping or queued.load() > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+// taskPool.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the taskPool class, a fixed set of worker threads
+//          that run fork/join tasks. Every thread owns a double ended queue
+//          of tasks: it pushes and pops its own tasks at the back, and when
+//          it runs out, it steals the oldest task from the front of another
+//          thread's queue. The thread that created the pool counts as one of
+//          its workers, so a pool of N threads starts N - 1 new ones. A
+//          thread that waits on its tasks runs other tasks while it waits
+//          rather than blocking, so tasks may spawn and wait on tasks of
+//          their own
+//
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+#ifndef _TASKPOOL_H_
+#define _TASKPOOL_H_
+
+class taskPool {
+public:
+    taskPool(int num_threads);
+    ~taskPool();
+
+    void spawn(function<void()> task, atomic<int> &pending);
+    void wait(atomic<int> &pending);
+
+    int size();
+
+private:
+    struct Task {
+        function<void()> run;
+        atomic<int> *pending;
+    };
+
+    struct Queue {
+        mutex lock;
+        deque<Task> tasks;
+    };
+
+    vector<Queue *> queues;
+    vector<thread> workers;
+
+    mutex sleep_lock;
+    condition_variable wake;
+    atomic<int> queued;
+    bool stopping;
+
+    int my_index();
+    bool pop_or_steal(int self, Task &task);
+    void run_task(Task &task);
+    void worker_loop(int self);
+};
+
+#endif
@@ -0,0 +1,231 @@
+// treeFile.cpp
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Implementation of the treeFile class
+//
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include "treeFile.h"
+
+using namespace std;
+
+static const char TREE_FILE_MAGIC[8] = { '2', '0', 'Q', 'T', 'R', 'E', 'E',
+                                         '\0' };
+
+// Function align8
+// Parameters: An offset into a file
+// Returns:    The offset rounded up to the next multiple of 8, so that every
+//             section of the file can be read in place as 64 bit words
+static uint64_t align8(uint64_t offset)
+{
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Function write_section
+// Parameters: The file being written, the number of bytes written to it so
+//             far, passed by reference, the offset that the section starts
+//             at, and the bytes of the section and how many there are
+// Returns:    None
+// Does:       Pads the file with zeros up to the offset, then writes the
+//             section
+static void write_section(ofstream &out, uint64_t &written, uint64_t offset,
+                          const void *bytes, uint64_t length)
+{
+    for (; written < offset; written++) {
+        out.put('\0');
+    }
+    out.write(static_cast<const char *>(bytes), length);
+    written += length;
+}
+
+// Constructor treeFile
+// Does: Initializes a treeFile that has not mapped any file yet
+treeFile::treeFile() : file("tree file")
+{
+    header = nullptr;
+}
+
+// Function write
+// Parameters: The name of the file to write, and the Contents to write to it
+// Returns:    None
+// Does:       Lays out the header and then each section at an offset that is
+//             a multiple of 8, the string table last, as a vector of offsets
+//             followed by the bytes of the strings themselves. The strings
+//             are the prompt, then each question, then each entry name.
+//             Prints an error and exits if the file cannot be written
+void treeFile::write(string filename, Contents &contents)
+{
+    vector<string *> strings;
+    strings.push_back(&contents.prompt);
+    for (size_t i = 0; i < contents.questions.size(); i++) {
+        strings.push_back(&contents.questions[i]);
+    }
+    for (size_t i = 0; i < contents.names.size(); i++) {
+        strings.push_back(&contents.names[i]);
+    }
+
+    vector<uint64_t> string_offsets;
+    uint64_t string_bytes = 0;
+    for (size_t i = 0; i < strings.size(); i++) {
+        string_offsets.push_back(string_bytes);
+        string_bytes += strings[i]->size();
+    }
+    string_offsets.push_back(string_bytes);
+
+    Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TREE_FILE_MAGIC, sizeof(h.magic));
+    h.byte_order = BYTE_ORDER_MARK;
+    h.format = TREE_FILE_FORMAT;
+    h.version = contents.version;
+    h.root = contents.root;
+    h.num_nodes = contents.num_nodes;
+    h.node_bytes = contents.node_bytes;
+    h.num_entries = contents.num_entries;
+    h.num_questions = contents.num_questions;
+    h.num_answers = contents.num_answers;
+    h.row_words = contents.row_words;
+
+    uint64_t node_section = static_cast<uint64_t>(h.num_nodes) * h.node_bytes;
+    uint64_t order_section = static_cast<uint64_t>(h.num_entries) *
+                             sizeof(int32_t);
+    uint64_t answer_section = static_cast<uint64_t>(h.num_entries) *
+                              h.row_words * sizeof(uint64_t);
+
+    h.nodes_offset = align8(sizeof(Header));
+    h.order_offset = align8(h.nodes_offset + node_section);
+    h.answers_offset = align8(h.order_offset + order_section);
+    h.string_offsets_offset = align8(h.answers_offset + answer_section);
+    h.strings_offset = h.string_offsets_offset +
+                       string_offsets.size() * sizeof(uint64_t);
+    h.strings_bytes = string_bytes;
+    h.file_bytes = h.strings_offset + string_bytes;
+
+    ofstream out(filename.c_str(), ios::binary | ios::trunc);
+    if (not out.is_open()) {
+        cerr << "Error opening tree file for writing: " << filename << endl;
+        exit(1);
+    }
+
+    uint64_t written = 0;
+    write_section(out, written, 0, &h, sizeof(h));
+    write_section(out, written, h.nodes_offset, contents.nodes, node_section);
+    write_section(out, written, h.order_offset, contents.order,
+                  order_section);
+    write_section(out, written, h.answers_offset, contents.answer_rows,
+                  answer_section);
+    write_section(out, written, h.string_offsets_offset,
+                  string_offsets.data(),
+                  string_offsets.size() * sizeof(uint64_t));
+    for (size_t i = 0; i < strings.size(); i++) {
+        out.write(strings[i]->data(), strings[i]->size());
+    }
+
+    if (not out.good()) {
+        cerr << "Error writing tree file: " << filename << endl;
+        exit(1);
+    }
+    out.close();
+}
+
+// Function map
+// Parameters: The name of a file written by write
+// Returns:    None
+// Does:       Maps the whole file read-only into memory, and has the
+//             mappedFile check its prefix and string table. Then checks that
+//             every section lies inside the file, in order, and that every
+//             index in the order vector is an entry, since the game reads
+//             them where they are mapped, without checking them again. The
+//             Nodes are checked by the KDtree that plays on them. Prints an
+//             error and exits if the file cannot be used
+void treeFile::map(string filename)
+{
+    file.map(filename, TREE_FILE_MAGIC, TREE_FILE_FORMAT, sizeof(Header));
+    header = reinterpret_cast<const Header *>(file.bytes());
+
+    const Header &h = *header;
+    uint64_t num_strings = 1 + static_cast<uint64_t>(h.num_questions) + 
+                           h.num_entries;
+    file.check_strings(h.string_offsets_offset, num_strings, 
+                       h.strings_offset, h.strings_bytes, h.file_bytes);
+    if (h.nodes_offset < sizeof(Header) or
+        h.nodes_offset + static_cast<uint64_t>(h.num_nodes) * h.node_bytes >
+            h.order_offset or
+        h.order_offset + static_cast<uint64_t>(h.num_entries) * 
+            sizeof(int32_t) > h.answers_offset or
+        h.answers_offset + static_cast<uint64_t>(h.num_entries) * 
+            h.row_words * sizeof(uint64_t) > h.string_offsets_offset) {
+        file.fail("has overlapping sections");
+    } else if (h.row_words != 
+               (static_cast<uint64_t>(h.num_answers) + 63) / 64) {
+        // The answers are read where they are mapped, as rows of an
+        // answerMatrix, so they must be exactly as wide as its rows
+        file.fail("has answers of the wrong width");
+    }
+
+    const int32_t *order = this->order();
+    for (uint32_t i = 0; i < h.num_entries; i++) {
+        if (order[i] < 0 or static_cast<uint32_t>(order[i]) >= h.num_entries) {
+            file.fail("has a damaged order");
+        }
+    }
+}
+
+double treeFile::version() const { return header->version; }
+uint32_t treeFile::root() const { return header->root; }
+uint32_t treeFile::num_nodes() const { return header->num_nodes; }
+uint32_t treeFile::node_bytes() const { return header->node_bytes; }
+uint32_t treeFile::num_entries() const { return header->num_entries; }
+uint32_t treeFile::num_questions() const { return header->num_questions; }
+uint32_t treeFile::num_answers() const { return header->num_answers; }
+uint32_t treeFile::row_words() const { return header->row_words; }
+
+// Function nodes
+// Returns: A pointer to the first of the mapped Nodes
+const void *treeFile::nodes() const
+{
+    return file.bytes() + header->nodes_offset;
+}
+
+// Function order
+// Returns: A pointer to the first element of the mapped order vector
+const int32_t *treeFile::order() const
+{
+    return reinterpret_cast<const int32_t *>(file.bytes() +
+                                             header->order_offset);
+}
+
+// Function answer_rows
+// Returns: A pointer to the first word of the mapped packed answers, laid out
+//          in the same way as the rows of an answerMatrix
+const uint64_t *treeFile::answer_rows() const
+{
+    return reinterpret_cast<const uint64_t *>(file.bytes() +
+                                              header->answers_offset);
+}
+
+// Function prompt
+// Returns: The prompt, the first line of the questions file
+string treeFile::prompt() const
+{
+    return file.string_at(0);
+}
+
+// Function question
+// Parameters: The index of a question
+// Returns:    The text of that question
+string treeFile::question(size_t q_index) const
+{
+    return file.string_at(1 + q_index);
+}
+
+// Function entry_name
+// Parameters: The index of an entry
+// Returns:    The name of that entry
+string treeFile::entry_name(size_t entry_index) const
+{
+    return file.string_at(1 + header->num_questions + entry_index);
+}
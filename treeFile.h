@@ -0,0 +1,99 @@
+// treeFile.h
+// By: Miles Izydorczak
+// Date: 18 October 2026
+// Purpose: Interface of the treeFile class, which writes a built KDtree to a
+//          binary file and maps such a file back into memory. The file holds
+//          every section that a game needs: the Nodes, the order vector that
+//          their pools are ranges of, the packed answers, and a string table
+//          of the prompt, the questions and the entry names. Every section
+//          is found by its offset from the start of the file and nothing in
+//          it is a pointer, so the mapped bytes are used as they are, and
+//          processes that map the same file share it in the page cache. The
+//          mapping, the header's prefix and the string table are checked by
+//          a mappedFile, and the sections of a tree file here
+//
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+#include "mappedFile.h"
+
+using namespace std;
+
+#ifndef _TREEFILE_H_
+#define _TREEFILE_H_
+
+// Bumped whenever the layout of the file, or of a Node, changes
+const uint32_t TREE_FILE_FORMAT = 1;
+
+class treeFile {
+public:
+    treeFile();
+
+    // Everything that goes into a file, given to write
+    struct Contents {
+        double version;
+        uint32_t root;
+        const void *nodes;
+        uint32_t num_nodes;
+        uint32_t node_bytes;
+        const int32_t *order;
+        uint32_t num_entries;
+        uint32_t num_questions;
+        const uint64_t *answer_rows;
+        uint32_t num_answers;
+        uint32_t row_words;
+        string prompt;
+        vector<string> questions;
+        vector<string> names;
+    };
+
+    static void write(string filename, Contents &contents);
+
+    void map(string filename);
+
+    double version() const;
+    uint32_t root() const;
+    uint32_t num_nodes() const;
+    uint32_t node_bytes() const;
+    uint32_t num_entries() const;
+    uint32_t num_questions() const;
+    uint32_t num_answers() const;
+    uint32_t row_words() const;
+
+    const void *nodes() const;
+    const int32_t *order() const;
+    const uint64_t *answer_rows() const;
+
+    string prompt() const;
+    string question(size_t q_index) const;
+    string entry_name(size_t entry_index) const;
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t byte_order;
+        uint32_t format;
+        double version;
+        uint32_t root;
+        uint32_t num_nodes;
+        uint32_t node_bytes;
+        uint32_t num_entries;
+        uint32_t num_questions;
+        uint32_t num_answers;
+        uint32_t row_words;
+        uint64_t nodes_offset;
+        uint64_t order_offset;
+        uint64_t answers_offset;
+        uint64_t string_offsets_offset;
+        uint64_t strings_offset;
+        uint64_t strings_bytes;
+        uint64_t file_bytes;
+    };
+
+    mappedFile file;
+    const Header *header;
+};
+
+#endif